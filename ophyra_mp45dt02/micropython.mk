@@ -2,6 +2,7 @@ EXAMPLE_MOD_DIR := $(USERMOD_DIR)
 
 # Add all C files to SRC_USERMOD.
 SRC_USERMOD += $(EXAMPLE_MOD_DIR)/ophyra_mp45dt02.c
+SRC_USERMOD += $(EXAMPLE_MOD_DIR)/pdm_filter.c
 
 # We can add our module folder to include paths if needed
 # This is not actually needed in this example.
@@ -0,0 +1,102 @@
+/*
+    mp45dt02_profiles.h
+
+    Output filters of ophyra_mp45dt02.c generated by pdm_filtergen.py, do not edit.
+    Intesc Electronica y Embebidos.
+
+    Only included by ophyra_mp45dt02.c after the definition of mp45dt02_biquad_t and mp45dt02_profile_t.
+*/
+
+/*
+    FLAT at 8000 Hz: high pass of order 2 at 20 Hz.
+*/
+static const mp45dt02_biquad_t profile_flat_8000[]=
+{
+    { 9.889542481e-01f, -1.977908496e+00f, 9.889542481e-01f, -1.977786484e+00f, 9.780305085e-01f },
+};
+
+/*
+    FLAT at 16000 Hz: high pass of order 2 at 20 Hz.
+*/
+static const mp45dt02_biquad_t profile_flat_16000[]=
+{
+    { 9.944617890e-01f, -1.988923578e+00f, 9.944617890e-01f, -1.988892906e+00f, 9.889542499e-01f },
+};
+
+/*
+    FLAT at 32000 Hz: high pass of order 2 at 20 Hz.
+*/
+static const mp45dt02_biquad_t profile_flat_32000[]=
+{
+    { 9.972270499e-01f, -1.994454100e+00f, 9.972270499e-01f, -1.994446411e+00f, 9.944617891e-01f },
+};
+
+/*
+    FLAT at 44100 Hz: high pass of order 2 at 20 Hz.
+*/
+static const mp45dt02_biquad_t profile_flat_44100[]=
+{
+    { 9.979871157e-01f, -1.995974231e+00f, 9.979871157e-01f, -1.995970180e+00f, 9.959782831e-01f },
+};
+
+/*
+    VOICE at 8000 Hz: high pass of order 4 at 300 Hz, low pass of order 4 at 3400 Hz.
+*/
+static const mp45dt02_biquad_t profile_voice_8000[]=
+{
+    { 8.112239216e-01f, -1.622447843e+00f, 8.112239216e-01f, -1.599719671e+00f, 6.451760153e-01f },
+    { 9.053086065e-01f, -1.810617213e+00f, 9.053086065e-01f, -1.785253057e+00f, 8.359813686e-01f },
+    { 6.661135642e-01f, 1.332227128e+00f, 6.661135642e-01f, 1.255440473e+00f, 4.090137832e-01f },
+    { 8.055511252e-01f, 1.611102250e+00f, 8.055511252e-01f, 1.518241844e+00f, 7.039626567e-01f },
+};
+
+/*
+    VOICE at 16000 Hz: high pass of order 4 at 300 Hz, low pass of order 4 at 3400 Hz.
+*/
+static const mp45dt02_biquad_t profile_voice_16000[]=
+{
+    { 8.989201352e-01f, -1.797840270e+00f, 8.989201352e-01f, -1.791587697e+00f, 8.040928440e-01f },
+    { 9.536398744e-01f, -1.907279749e+00f, 9.536398744e-01f, -1.900646564e+00f, 9.139129337e-01f },
+    { 2.018999550e-01f, 4.037999099e-01f, 2.018999550e-01f, -2.459452007e-01f, 5.354502051e-02f },
+    { 2.793342790e-01f, 5.586685580e-01f, 2.793342790e-01f, -3.402721180e-01f, 4.576092340e-01f },
+};
+
+/*
+    VOICE at 32000 Hz: high pass of order 4 at 300 Hz, low pass of order 4 at 3400 Hz.
+*/
+static const mp45dt02_biquad_t profile_voice_32000[]=
+{
+    { 9.475936323e-01f, -1.895187265e+00f, 9.475936323e-01f, -1.893542341e+00f, 8.968321878e-01f },
+    { 9.771193982e-01f, -1.954238796e+00f, 9.771193982e-01f, -1.952542620e+00f, 9.559349733e-01f },
+    { 6.828479903e-02f, 1.365695981e-01f, 6.828479903e-02f, -9.991511491e-01f, 2.722903452e-01f },
+    { 8.678151790e-02f, 1.735630358e-01f, 8.678151790e-02f, -1.269797298e+00f, 6.169233700e-01f },
+};
+
+/*
+    VOICE at 44100 Hz: high pass of order 4 at 300 Hz, low pass of order 4 at 3400 Hz.
+*/
+static const mp45dt02_biquad_t profile_voice_44100[]=
+{
+    { 9.615827992e-01f, -1.923165598e+00f, 9.615827992e-01f, -1.922286952e+00f, 9.240442445e-01f },
+    { 9.834618008e-01f, -1.966923602e+00f, 9.834618008e-01f, -1.966024964e+00f, 9.678222397e-01f },
+    { 4.022173319e-02f, 8.044346637e-02f, 4.022173319e-02f, -1.237475345e+00f, 3.983622779e-01f },
+    { 4.882555876e-02f, 9.765111751e-02f, 4.882555876e-02f, -1.502183531e+00f, 6.974857659e-01f },
+};
+
+static const mp45dt02_profile_t mp45dt02_profiles[]=
+{
+    { 8000, PROFILE_NONE, 0, NULL },
+    { 16000, PROFILE_NONE, 0, NULL },
+    { 32000, PROFILE_NONE, 0, NULL },
+    { 44100, PROFILE_NONE, 0, NULL },
+    { 8000, PROFILE_FLAT, 1, profile_flat_8000 },
+    { 16000, PROFILE_FLAT, 1, profile_flat_16000 },
+    { 32000, PROFILE_FLAT, 1, profile_flat_32000 },
+    { 44100, PROFILE_FLAT, 1, profile_flat_44100 },
+    { 8000, PROFILE_VOICE, 4, profile_voice_8000 },
+    { 16000, PROFILE_VOICE, 4, profile_voice_16000 },
+    { 32000, PROFILE_VOICE, 4, profile_voice_32000 },
+    { 44100, PROFILE_VOICE, 4, profile_voice_44100 },
+};
+
+#define PROFILE_BIQUADS_MAX (4)
@@ -21,11 +21,42 @@
 #include "pin.h"
 #include "dma.h"
 #include "py/mphal.h"    
+#include "pdm_filter.h"
 
-#define FREC_PDM 176000
-#define FREC_PCM 44000
-#define LONG_BUF 6 * 2
-#define HALF_BUF (LONG_BUF/2)
+/*
+    The clock of the microphone is the PCM rate times the decimation of pdm_filter.c, the MP45DT02 takes
+    FREC_PDM_MIN to FREC_PDM_MAX. Every I2S frame of 16 bit data has 32 clocks.
+*/
+#define FREC_PCM_DEFAULT    44100
+#define FREC_PDM_MIN        1000000
+#define FREC_PDM_MAX        3250000
+/*
+    The DMA buffer is circular and split in two halves, every half holds dma_samples PCM samples of pdm_words
+    (decimation/16) half-words of PDM data. The half and complete callbacks decimate a whole half, so there
+    are two interrupts per dma_samples samples instead of one per sample.
+*/
+#define DMA_SAMPLES         64
+#define DMA_SAMPLES_MAX     1024
+
+/*
+    Output filter applied by filtro() after pdm_filter.c, a cascade of biquads per sample rate.
+*/
+#define PROFILE_NONE        (0)     // output of pdm_filter.c, flat up to 0.4 times the rate with the offset
+#define PROFILE_FLAT        (1)     // flat, removes the offset with a high pass at 20 Hz
+#define PROFILE_VOICE       (2)     // band pass from 300 Hz to 3400 Hz
+
+typedef struct _mp45dt02_biquad_t {
+    float b0, b1, b2, a1, a2;       // a0 is 1
+} mp45dt02_biquad_t;
+
+typedef struct _mp45dt02_profile_t {
+    uint32_t rate;
+    uint8_t profile;
+    uint8_t n_biquads;
+    const mp45dt02_biquad_t *biquads;
+} mp45dt02_profile_t;
+
+#include "mp45dt02_profiles.h"
 
 typedef struct _non_blocking_descriptor_t {
     mp_buffer_info_t appbuf;
@@ -36,7 +67,28 @@ typedef struct _non_blocking_descriptor_t {
 typedef struct _mp45dt02_obj_t {
     mp_obj_base_t base;
     mp_obj_t callback_for_non_blocking;
-    uint16_t dma_buffer[LONG_BUF];
+    uint16_t *dma_buffer;
+    uint16_t dma_samples;
+    uint32_t dma_len;                   // half-words of dma_buffer
+    uint32_t rate;
+    uint8_t decimation;
+    uint8_t pdm_words;
+    pdm_filter_t pdm;
+    const mp45dt02_profile_t *filter;
+    float biquad_state[PROFILE_BIQUADS_MAX][2];
+    bool running;
+    /*
+        Continuous mode (ibuf > 0): ring of PCM samples, the DMA callbacks are the only writers of ring_head
+        and readinto() the only writer of ring_tail, one slot is always empty.
+    */
+    int16_t *ring;
+    uint32_t ring_size;
+    volatile uint32_t ring_head;
+    volatile uint32_t ring_tail;
+    uint32_t ring_threshold;            // samples in the ring that schedule the callback
+    volatile bool ring_armed;
+    volatile uint32_t overrun_events;   // times the callbacks found the ring full
+    volatile uint32_t overrun_samples;  // samples lost
     non_blocking_descriptor_t non_blocking_descriptor;
     
     I2S_HandleTypeDef hi2s2;
@@ -47,214 +99,130 @@ typedef struct _mp45dt02_obj_t {
 STATIC mp_obj_t mp45dt02_deinit(mp_obj_t self_in);
 
 const mp_obj_type_t mp45dt02_type;
-STATIC mp45dt02_obj_t *mp45dt02_obj;
- 
+
+/*
+    The only instance is a root pointer so the GC keeps it, its DMA buffer and its ring while the DMA and the
+    callbacks use them, even if the script drops the object. MicroPython versions without MP_REGISTER_ROOT_POINTER
+    need it in mpconfigboard.h:
+        #define MICROPY_BOARD_ROOT_POINTERS struct _mp45dt02_obj_t *mp45dt02_obj;
+*/
+#ifdef MP_REGISTER_ROOT_POINTER
+MP_REGISTER_ROOT_POINTER(struct _mp45dt02_obj_t *mp45dt02_obj);
+#endif
+
 void mp45dt02_init0() {
     
-    mp45dt02_obj = NULL;
+    MP_STATE_PORT(mp45dt02_obj) = NULL;
    
 }
  
-#define WINDOWS    64
-
-uint16_t sincfilter[WINDOWS] = {0, 2, 9, 21, 39, 63, 94, 132, 179, 236, 302, 379, 467, 565, 674, 792,920, 1055, 1196, 1341, 1487, 1633, 1776, 1913, 2042, 2159, 2263, 2352, 2422, 2474, 2506, 2516,
-	2516,2506, 2474, 2422, 2352, 2263, 2159, 2042, 1913, 1776, 1633, 1487, 1341, 1196, 1055, 920, 792,674, 565, 467, 379, 302, 236, 179, 132, 94, 63, 39, 21, 9, 2, 0};
-
-#define PDM_REPEAT_LOOP_16(X) X X X X X X X X X X X X X X X X
-
-#define M 103
-float h[M] = {
-
-
-
-  0.005383878543905767,//50-1000,1500 44k  103
-  0.0008745285494715447,
-  0.0008482121881024766,
-  0.0007460661434193918,
-  0.0005591943982935655,
-  0.0002791528160262167,
-  -0.00009918091362182439,
-  -0.0005811661980721277,
-  -0.0011671893566906496,
-  -0.0018565212849891023,
-  -0.002645092214276294,
-  -0.0035243971082051908,
-  -0.004482296433960019,
-  -0.005504049776296296,
-  -0.00657090631514472,
-  -0.007660384600351277,
-  -0.008746718621093214,
-  -0.009800854443203912,
-  -0.010792801755240751,
-  -0.011690626248753846,
-  -0.012460044110719715,
-  -0.013066138954722997,
-  -0.013478050976535164,
-  -0.013661419705534182,
-  -0.01358814972261887,
-  -0.013230659567661602,
-  -0.012569445996477512,
-  -0.01157485826919379,
-  -0.01025972395735936,
-  -0.008591627155855458,
-  -0.0065797395189081615,
-  -0.004235785042586487,
-  -0.0015738584167381312,
-  0.0013871360655679007,
-  0.0046189335455996275,
-  0.008086638890839394,
-  0.011747688496100916,
-  0.015554266016657506,
-  0.019454870341107575,
-  0.023394135061082386,
-  0.02731338070322758,
-  0.031152907654284957,
-  0.03485296501818983,
-  0.03835421967664724,
-  0.04159966314102669,
-  0.04453367705215179,
-  0.04710590599599399,
-  0.049273780397548254,
-  0.05100223257635541,
-  0.052255648506699295,
-  0.05301808055521172,
-  0.05327320160592689,
-  0.05301808055521172,
-  0.052255648506699295,
-  0.05100223257635541,
-  0.049273780397548254,
-  0.04710590599599399,
-  0.04453367705215179,
-  0.04159966314102669,
-  0.03835421967664724,
-  0.03485296501818983,
-  0.031152907654284957,
-  0.02731338070322758,
-  0.023394135061082386,
-  0.019454870341107575,
-  0.015554266016657506,
-  0.011747688496100916,
-  0.008086638890839394,
-  0.0046189335455996275,
-  0.0013871360655679007,
-  -0.0015738584167381312,
-  -0.004235785042586487,
-  -0.0065797395189081615,
-  -0.008591627155855458,
-  -0.01025972395735936,
-  -0.01157485826919379,
-  -0.012569445996477512,
-  -0.013230659567661602,
-  -0.01358814972261887,
-  -0.013661419705534182,
-  -0.013478050976535164,
-  -0.013066138954722997,
-  -0.012460044110719715,
-  -0.011690626248753846,
-  -0.010792801755240751,
-  -0.009800854443203912,
-  -0.008746718621093214,
-  -0.007660384600351277,
-  -0.00657090631514472,
-  -0.005504049776296296,
-  -0.004482296433960019,
-  -0.0035243971082051908,
-  -0.002645092214276294,
-  -0.0018565212849891023,
-  -0.0011671893566906496,
-  -0.0005811661980721277,
-  -0.00009918091362182439,
-  0.0002791528160262167,
-  0.0005591943982935655,
-  0.0007460661434193918,
-  0.0008482121881024766,
-  0.0008745285494715447,
-  0.005383878543905767
-
-};
-
-
-float x_n[M+1]={0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+/*
+    filtro() output filter at the PCM rate, the biquads of the profile in direct form II transposed.
+    Returns the input with PROFILE_NONE.
+*/
+STATIC float filtro(mp45dt02_obj_t *self, float x) {
+    const mp45dt02_biquad_t *b = self->filter->biquads;
+    float (*z)[2] = self->biquad_state;
+
+    for (uint8_t k = 0; k < self->filter->n_biquads; k++, b++, z++) {
+        float y = b->b0 * x + (*z)[0];
+        (*z)[0] = b->b1 * x - b->a1 * y + (*z)[1];
+        (*z)[1] = b->b2 * x - b->a2 * y;
+        x = y;
+    }
+    return x;
+}
 
 
+void HAL_I2S_ErrorCallback(I2S_HandleTypeDef *hi2s2) {
+    uint32_t errorCode = HAL_I2S_GetError(hi2s2);
+    printf("I2S Error = %ld\n", errorCode);
+}
 
-float filtro(int in){
-	float y=0;
+STATIC uint32_t mp45dt02_ring_available(mp45dt02_obj_t *self) {
+    uint32_t head = self->ring_head;
+    uint32_t tail = self->ring_tail;
+    return (head >= tail) ? head - tail : head + self->ring_size - tail;
+}
 
-	x_n[0] = in;
-	y = h[0] * x_n[0];
-	for(int j=1;j<M;j++){
-		y += h[j] * x_n[j];
-	};
+STATIC int16_t mp45dt02_sample(mp45dt02_obj_t *self, const uint16_t *pdm) {
+    int16_t pcm;
+    pdm_filter_run(&self->pdm, pdm, self->pdm_words, &pcm);
+    float y = filtro(self, pcm);
+    return (y > 32767) ? 32767 : ((y < -32768) ? -32768 : (int16_t)y);
+}
 
-	for (int i=M;i>0;i--){
-		x_n[i]=x_n[i-1];
-	};
-	return y;
+/*
+    mp45dt02_decimate_ring() continuous mode of mp45dt02_decimate(), every sample goes to the ring. When it is
+    full the new samples are dropped and counted, the samples already in the ring are never overwritten.
+*/
+STATIC void mp45dt02_decimate_ring(mp45dt02_obj_t *self, const uint16_t *pdm) {
+    uint32_t head = self->ring_head;
+    uint32_t tail = self->ring_tail;
+    uint32_t lost = 0;
+
+    for (uint16_t s = 0; s < self->dma_samples; s++, pdm += self->pdm_words) {
+        int16_t pcm = mp45dt02_sample(self, pdm);
+        uint32_t next = (head + 1 < self->ring_size) ? head + 1 : 0;
+        if (next == tail) {
+            lost++;
+            continue;
+        }
+        self->ring[head] = pcm;
+        head = next;
+    }
+    // The samples are stored before the new head is visible to readinto()
+    self->ring_head = head;
+    if (lost > 0) {
+        self->overrun_events++;
+        self->overrun_samples += lost;
+    }
+    if (self->ring_armed && mp45dt02_ring_available(self) >= self->ring_threshold) {
+        self->ring_armed = false;
+        if (self->callback_for_non_blocking != MP_OBJ_NULL && self->callback_for_non_blocking != mp_const_none) {
+            mp_sched_schedule(self->callback_for_non_blocking, MP_OBJ_FROM_PTR(self));
+        }
+    }
 }
 
+/*
+    mp45dt02_decimate() converts one half of the DMA buffer, dma_samples blocks of pdm_words half-words,
+    to signed 16 bit PCM samples stored in the buffer given to readinto(): pdm_filter_run() and the output
+    filter of filtro().
+*/
+STATIC void mp45dt02_decimate(mp45dt02_obj_t *self, const uint16_t *pdm) {
+    non_blocking_descriptor_t *desc = &self->non_blocking_descriptor;
 
-void HAL_I2S_ErrorCallback(I2S_HandleTypeDef *hi2s2) {
-    uint32_t errorCode = HAL_I2S_GetError(hi2s2);
-    printf("I2S Error = %ld\n", errorCode);
+    if (self->ring != NULL) {
+        mp45dt02_decimate_ring(self, pdm);
+        return;
+    }
+    for (uint16_t s = 0; s < self->dma_samples && desc->copy_in_progress; s++, pdm += self->pdm_words) {
+        ((int16_t *)desc->appbuf.buf)[desc->index] = mp45dt02_sample(self, pdm);
+        desc->index++;
+        if (desc->index * 2 >= desc->appbuf.len) {
+            desc->copy_in_progress = false;
+            if (self->callback_for_non_blocking != MP_OBJ_NULL && self->callback_for_non_blocking != mp_const_none) {
+                mp_sched_schedule(self->callback_for_non_blocking, MP_OBJ_FROM_PTR(self));
+            }
+        }
+    }
 }
 
 void HAL_I2S_RxCpltCallback(I2S_HandleTypeDef *hi2s2) {
-    
-    mp45dt02_obj_t *self;
-    self = mp45dt02_obj;   
-    
-    if (self->non_blocking_descriptor.copy_in_progress) {
-        uint16_t runningsum = 0;
-		uint16_t *sinc_ptr = sincfilter;
-		for (uint8_t i=HALF_BUF; i <= HALF_BUF+3 ; i++) {
-			PDM_REPEAT_LOOP_16({
-				if (self->dma_buffer[i] & 0x1) {
-					runningsum += *sinc_ptr;
-				}
-				sinc_ptr++;
-				self->dma_buffer[i] >>= 1;
-			})
-		}
-		if (self->non_blocking_descriptor.index*2 >= self->non_blocking_descriptor.appbuf.len){
-            self->non_blocking_descriptor.copy_in_progress = false;
-            mp_sched_schedule(self->callback_for_non_blocking, MP_OBJ_FROM_PTR(self));
-            
-		}
-	    ((uint16_t *)self->non_blocking_descriptor.appbuf.buf)[self->non_blocking_descriptor.index] = (uint16_t)filtro(runningsum);
-	    self->non_blocking_descriptor.index++;
+    mp45dt02_obj_t *self = MP_STATE_PORT(mp45dt02_obj);
+
+    if (self != NULL) {
+        mp45dt02_decimate(self, &self->dma_buffer[self->dma_samples * self->pdm_words]);
     }
 }
 
 void HAL_I2S_RxHalfCpltCallback(I2S_HandleTypeDef *hi2s2) {
-    mp45dt02_obj_t *self;
-    self = mp45dt02_obj;
-    
-    
-    
+    mp45dt02_obj_t *self = MP_STATE_PORT(mp45dt02_obj);
 
-    if (self->non_blocking_descriptor.copy_in_progress)  {
-        uint16_t runningsum = 0;
-        uint16_t *sinc_ptr = sincfilter;
-	    for (uint8_t i=0; i <= 3 ; i++) {
-		    PDM_REPEAT_LOOP_16({
-			if (self->dma_buffer[i] & 0x1) {
-				runningsum += *sinc_ptr;
-			}
-			sinc_ptr++;
-			self->dma_buffer[i] >>= 1;
-		    })
-	    }
-	    if (self->non_blocking_descriptor.index*2 >= self->non_blocking_descriptor.appbuf.len){
-		    self->non_blocking_descriptor.copy_in_progress = false;
-            mp_sched_schedule(self->callback_for_non_blocking, MP_OBJ_FROM_PTR(self));
-            
-	    }
-	    ((uint16_t *)self->non_blocking_descriptor.appbuf.buf)[self->non_blocking_descriptor.index] = (uint16_t)filtro(runningsum);
-	    self->non_blocking_descriptor.index++;
-    
+    if (self != NULL) {
+        mp45dt02_decimate(self, &self->dma_buffer[0]);
     }
-    
 }
 
 STATIC void mp45dt02_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
@@ -311,8 +279,106 @@ STATIC bool i2s_init(mp45dt02_obj_t *self) {
 
 }
 
-STATIC void mp45dt02_init_helper(mp45dt02_obj_t *self) {
+/*
+    Arguments of the constructor and init(), keywords only:
+        -> rate PCM samples per second: 8000, 16000, 32000 or 44100 (default).
+        -> decimation of pdm_filter.c: 16, 32, 64 or 128, the clock of the microphone is rate*decimation and
+           has to be from 1 to 3.25 MHz. With 0 (default) the highest decimation in that range is used.
+        -> profile of the output filter: MP45DT02.FLAT (default), MP45DT02.VOICE or MP45DT02.NONE.
+        -> samples PCM samples converted by every interrupt, 1 to DMA_SAMPLES_MAX. The DMA buffer takes
+           samples*decimation/4 bytes (1 KB with the defaults at 44100), more samples mean less interrupts
+           but a longer delay until readinto() sees them.
+        -> ibuf bytes of the ring of the continuous mode, 0 (default) for the non-blocking mode. In the
+           continuous mode the microphone is captured all the time, readinto() waits until the buffer is
+           full and the samples that do not fit in the ring are counted by overruns().
+        -> threshold bytes in the ring that schedule the callback of irq() in the continuous mode,
+           by default half of ibuf. The callback runs again once readinto() takes the ring below it.
+    The work per second grows with rate*decimation, 8000 or 16000 with VOICE is enough for speech.
+*/
+STATIC void mp45dt02_init_helper(mp45dt02_obj_t *self, size_t n_pos_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_rate, ARG_decimation, ARG_profile, ARG_samples, ARG_ibuf, ARG_threshold };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_rate,       MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = FREC_PCM_DEFAULT} },
+        { MP_QSTR_decimation, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_profile,    MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = PROFILE_FLAT} },
+        { MP_QSTR_samples,    MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = DMA_SAMPLES} },
+        { MP_QSTR_ibuf,       MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_threshold,  MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_pos_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_int_t rate = args[ARG_rate].u_int;
+    mp_int_t profile = args[ARG_profile].u_int;
+    const mp45dt02_profile_t *filter = NULL;
+    for (size_t i = 0; i < MP_ARRAY_SIZE(mp45dt02_profiles); i++) {
+        if (mp45dt02_profiles[i].rate == rate && mp45dt02_profiles[i].profile == profile) {
+            filter = &mp45dt02_profiles[i];
+        }
+    }
+    if (filter == NULL) {
+        if (profile < PROFILE_NONE || profile > PROFILE_VOICE) {
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid profile"));
+        }
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid rate"));
+    }
+
+    mp_int_t decimation = args[ARG_decimation].u_int;
+    if (decimation == 0) {
+        decimation = 128;
+        while (decimation > 16 && rate * decimation > FREC_PDM_MAX) {
+            decimation /= 2;
+        }
+    }
+    if (!pdm_filter_init(&self->pdm, decimation)
+        || rate * decimation < FREC_PDM_MIN || rate * decimation > FREC_PDM_MAX) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid decimation"));
+    }
 
+    if (args[ARG_samples].u_int < 1 || args[ARG_samples].u_int > DMA_SAMPLES_MAX) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid samples"));
+    }
+    uint32_t dma_len = 2 * args[ARG_samples].u_int * (decimation / 16);
+    if (self->dma_buffer == NULL || self->dma_len != dma_len) {
+        if (self->dma_buffer != NULL) {
+            m_del(uint16_t, self->dma_buffer, self->dma_len);
+        }
+        self->dma_buffer = m_new(uint16_t, dma_len);
+        self->dma_len = dma_len;
+    }
+
+    mp_int_t ibuf = args[ARG_ibuf].u_int;
+    mp_int_t threshold = args[ARG_threshold].u_int;
+    if (ibuf < 0 || (ibuf > 0 && ibuf < 4)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid ibuf"));
+    }
+    if (threshold < 0 || (threshold > 0 && threshold > 2 * (ibuf / 2 - 1))) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid threshold"));
+    }
+    uint32_t ring_size = (ibuf > 0) ? ibuf / 2 : 0;
+    if (self->ring_size != ring_size) {
+        if (self->ring != NULL) {
+            m_del(int16_t, self->ring, self->ring_size);
+            self->ring = NULL;
+        }
+        if (ring_size > 0) {
+            self->ring = m_new(int16_t, ring_size);
+        }
+        self->ring_size = ring_size;
+    }
+    self->ring_head = 0;
+    self->ring_tail = 0;
+    self->ring_threshold = (threshold > 0) ? threshold / 2 : ring_size / 2;
+    self->ring_armed = true;
+    self->overrun_events = 0;
+    self->overrun_samples = 0;
+
+    self->dma_samples = args[ARG_samples].u_int;
+    self->rate = rate;
+    self->decimation = decimation;
+    self->pdm_words = decimation / 16;
+    self->filter = filter;
+    memset(self->biquad_state, 0, sizeof(self->biquad_state));
     memset(&self->hi2s2, 0, sizeof(self->hi2s2));
 
     self->callback_for_non_blocking = MP_OBJ_NULL;
@@ -323,7 +389,7 @@ STATIC void mp45dt02_init_helper(mp45dt02_obj_t *self) {
     init->Standard = I2S_STANDARD_PHILIPS;
     init->DataFormat = I2S_DATAFORMAT_16B;
     init->MCLKOutput = I2S_MCLKOUTPUT_DISABLE;
-    init->AudioFreq = FREC_PDM;
+    init->AudioFreq = self->rate * self->decimation / 32;
     init->CPOL = I2S_CPOL_LOW;
     init->ClockSource = I2S_CLOCK_PLL;
     init->FullDuplexMode = I2S_FULLDUPLEXMODE_DISABLE;
@@ -333,38 +399,47 @@ STATIC void mp45dt02_init_helper(mp45dt02_obj_t *self) {
     }
     
     HAL_StatusTypeDef status;
-    status = HAL_I2S_Receive_DMA(&self->hi2s2,&self->dma_buffer[0], HALF_BUF);
+    status = HAL_I2S_Receive_DMA(&self->hi2s2, self->dma_buffer, self->dma_len);
     
 
     if (status != HAL_OK) {
         mp_raise_msg_varg(&mp_type_OSError, MP_ERROR_TEXT("DMA init failed"));
     }
+    self->running = true;
 }
 
 
 
 STATIC mp_obj_t mp45dt02_make_new(const mp_obj_type_t *type, size_t n_pos_args, size_t n_kw_args, const mp_obj_t *args) {
-    mp_arg_check_num(n_pos_args, n_kw_args, 0, 0, false);
+    mp_arg_check_num(n_pos_args, n_kw_args, 0, 0, true);
     
     mp45dt02_obj_t *self;
 
-    if (mp45dt02_obj == NULL) {
+    if (MP_STATE_PORT(mp45dt02_obj) == NULL) {
         self = m_new_obj(mp45dt02_obj_t);
-        mp45dt02_obj = self;
         self->base.type = &mp45dt02_type;
+        self->dma_buffer = NULL;
+        self->dma_samples = 0;
+        self->dma_len = 0;
+        self->ring = NULL;
+        self->ring_size = 0;
+        self->running = false;
+        MP_STATE_PORT(mp45dt02_obj) = self;
     } else {
-        self = mp45dt02_obj;
+        self = MP_STATE_PORT(mp45dt02_obj);
         mp45dt02_deinit(MP_OBJ_FROM_PTR(self));
     }
 
-    mp45dt02_init_helper(self);
+    mp_map_t kw_args;
+    mp_map_init_fixed_table(&kw_args, n_kw_args, args + n_pos_args);
+    mp45dt02_init_helper(self, n_pos_args, args, &kw_args);
     return MP_OBJ_FROM_PTR(self);
 }
 
 STATIC mp_obj_t mp45dt02_init(size_t n_pos_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     mp45dt02_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
     mp45dt02_deinit(MP_OBJ_FROM_PTR(self));
-    mp45dt02_init_helper(self);
+    mp45dt02_init_helper(self, n_pos_args - 1, pos_args + 1, kw_args);
     self->non_blocking_descriptor.copy_in_progress = true;
     return mp_const_none;
 }
@@ -374,6 +449,7 @@ STATIC mp_obj_t mp45dt02_deinit(mp_obj_t self_in) {
 
     mp45dt02_obj_t *self = MP_OBJ_TO_PTR(self_in);
 
+    self->running = false;
     dma_deinit(self->dma_descr_rx);
     HAL_I2S_DeInit(&self->hi2s2);
 
@@ -405,6 +481,66 @@ STATIC mp_obj_t mp45dt02_irq(mp_obj_t self_in, mp_obj_t handler) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp45dt02_irq_obj, mp45dt02_irq);
 
+/*
+    any() bytes waiting in the ring of the continuous mode, readinto() of that size does not wait.
+*/
+STATIC mp_obj_t mp45dt02_any(mp_obj_t self_in) {
+    mp45dt02_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->ring == NULL) {
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    return mp_obj_new_int_from_uint(2 * mp45dt02_ring_available(self));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp45dt02_any_obj, mp45dt02_any);
+
+/*
+    overruns() tuple (times the ring was full, samples lost) of the continuous mode since init().
+*/
+STATIC mp_obj_t mp45dt02_overruns(mp_obj_t self_in) {
+    mp45dt02_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int_from_uint(self->overrun_events),
+        mp_obj_new_int_from_uint(self->overrun_samples),
+    };
+
+    return mp_obj_new_tuple(2, tuple);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp45dt02_overruns_obj, mp45dt02_overruns);
+
+/*
+    mp45dt02_ring_read() readinto() of the continuous mode, takes n samples from the ring and waits for them
+    while the microphone is running.
+*/
+STATIC mp_uint_t mp45dt02_ring_read(mp45dt02_obj_t *self, int16_t *buf, mp_uint_t n, int *errcode) {
+    mp_uint_t got = 0;
+
+    while (got < n) {
+        uint32_t available = mp45dt02_ring_available(self);
+        if (available == 0) {
+            if (!self->running) {
+                break;
+            }
+            MICROPY_EVENT_POLL_HOOK
+            continue;
+        }
+        uint32_t tail = self->ring_tail;
+        uint32_t chunk = MIN(MIN(available, n - got), self->ring_size - tail);
+        memcpy(&buf[got], &self->ring[tail], 2 * chunk);
+        got += chunk;
+        // The samples are copied before the slots are given back to the callbacks
+        self->ring_tail = (tail + chunk < self->ring_size) ? tail + chunk : 0;
+    }
+    if (mp45dt02_ring_available(self) < self->ring_threshold) {
+        self->ring_armed = true;
+    }
+    if (got == 0 && n > 0) {
+        *errcode = MP_EIO;
+        return MP_STREAM_ERROR;
+    }
+    return 2 * got;
+}
+
 
 STATIC mp_uint_t mp45dt02_stream_read(mp_obj_t self_in, void *buf_in, mp_uint_t size, int *errcode) {
     mp45dt02_obj_t *self = MP_OBJ_TO_PTR(self_in);
@@ -412,6 +548,9 @@ STATIC mp_uint_t mp45dt02_stream_read(mp_obj_t self_in, void *buf_in, mp_uint_t
     if (size == 0) {
         return 0;
     }
+    if (self->ring != NULL) {
+        return mp45dt02_ring_read(self, buf_in, size / 2, errcode);
+    }
 
     self->non_blocking_descriptor.appbuf.buf = (void *)buf_in;
     self->non_blocking_descriptor.appbuf.len = size;
@@ -425,6 +564,11 @@ STATIC const mp_rom_map_elem_t mp45dt02_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_readinto),        MP_ROM_PTR(&mp_stream_readinto_obj) },
     { MP_ROM_QSTR(MP_QSTR_deinit),          MP_ROM_PTR(&mp45dt02_deinit_obj) },
     { MP_ROM_QSTR(MP_QSTR_irq),             MP_ROM_PTR(&mp45dt02_irq_obj) },
+    { MP_ROM_QSTR(MP_QSTR_any),             MP_ROM_PTR(&mp45dt02_any_obj) },
+    { MP_ROM_QSTR(MP_QSTR_overruns),        MP_ROM_PTR(&mp45dt02_overruns_obj) },
+    { MP_ROM_QSTR(MP_QSTR_NONE),            MP_ROM_INT(PROFILE_NONE) },
+    { MP_ROM_QSTR(MP_QSTR_FLAT),            MP_ROM_INT(PROFILE_FLAT) },
+    { MP_ROM_QSTR(MP_QSTR_VOICE),           MP_ROM_INT(PROFILE_VOICE) },
 
 };
 MP_DEFINE_CONST_DICT(mp45dt02_locals_dict, mp45dt02_locals_dict_table);
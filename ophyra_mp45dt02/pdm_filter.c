@@ -0,0 +1,112 @@
+/*
+    pdm_filter.c
+
+    PDM to PCM conversion for the MP45DT02 microphone, see pdm_filter.h.
+    Intesc Electronica y Embebidos.
+*/
+
+#include <string.h>
+#include "pdm_filter.h"
+#include "pdm_filter_coefs.h"
+
+/*
+    pdm_smlad() returns acc plus the products of the low and the high half-words of x and y,
+    a single instruction on the Cortex-M4.
+*/
+static inline int32_t pdm_smlad(uint32_t x, uint32_t y, int32_t acc) {
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+    int32_t r;
+    __asm__ ("smlad %0, %1, %2, %3" : "=r" (r) : "r" (x), "r" (y), "r" (acc));
+    return r;
+#else
+    return acc + (int16_t)x * (int16_t)y + (int16_t)(x >> 16) * (int16_t)(y >> 16);
+#endif
+}
+
+static inline int16_t pdm_sat16(int32_t v) {
+    return (v > 32767) ? 32767 : ((v < -32768) ? -32768 : v);
+}
+
+bool pdm_filter_init(pdm_filter_t *f, uint16_t decimation) {
+    memset(f, 0, sizeof(*f));
+    switch (decimation) {
+        case 16:
+            f->fir = pdm_fir_16;
+            break;
+        case 32:
+            f->fir = pdm_fir_32;
+            break;
+        case 64:
+            f->fir = pdm_fir_64;
+            break;
+        case 128:
+            f->fir = pdm_fir_128;
+            break;
+        default:
+            return false;
+    }
+    f->r2 = decimation / 16;
+    // The gain of the CIC is 2*8^4 in stage 1 and r2^4 in stage 2
+    f->shift = 12 + PDM_CIC_ORDER * (31 - __builtin_clz(f->r2)) - 14;
+    return true;
+}
+
+/*
+    pdm_fir() is the output of stage 3 for the window of PDM_FIR_TAPS samples starting at x, the oldest first.
+    The coefficients are symmetric so they are not reversed.
+*/
+static int16_t pdm_fir(const int16_t *fir, const int16_t *x) {
+    int32_t acc = 0;
+    for (uint16_t k = 0; k < PDM_FIR_TAPS; k += 2) {
+        uint32_t xx, cc;
+        memcpy(&xx, &x[k], 4);
+        memcpy(&cc, &fir[k], 4);
+        acc = pdm_smlad(xx, cc, acc);
+    }
+    return pdm_sat16(acc >> 14);
+}
+
+size_t pdm_filter_run(pdm_filter_t *f, const uint16_t *pdm, size_t words, int16_t *pcm) {
+    size_t n = 0;
+
+    for (size_t b = 0; b < 2 * words; b++) {
+        uint8_t byte = (b & 1) ? (pdm[b >> 1] & 0xFF) : (pdm[b >> 1] >> 8);
+
+        // Stage 1, the output is the density of ones of the last 29 bits from -4096 to 4096
+        int32_t s1 = 2 * (pdm_cic1[byte] + pdm_cic1[256 + f->hist[0]] + pdm_cic1[512 + f->hist[1]]
+            + pdm_cic1[768 + f->hist[2]]) - 4096;
+        f->hist[2] = f->hist[1];
+        f->hist[1] = f->hist[0];
+        f->hist[0] = byte;
+
+        // Stage 2
+        uint32_t acc = (uint32_t)s1;
+        for (uint8_t k = 0; k < PDM_CIC_ORDER; k++) {
+            f->integ[k] += acc;
+            acc = f->integ[k];
+        }
+        if (++f->phase < f->r2) {
+            continue;
+        }
+        f->phase = 0;
+        for (uint8_t k = 0; k < PDM_CIC_ORDER; k++) {
+            uint32_t t = acc;
+            acc -= f->comb[k];
+            f->comb[k] = t;
+        }
+        int32_t s2 = (int32_t)acc;
+        s2 = (f->shift >= 0) ? (s2 >> f->shift) : (int32_t)((uint32_t)s2 << -f->shift);
+
+        // Stage 3
+        int16_t x = pdm_sat16(s2);
+        f->line[f->pos] = x;
+        f->line[f->pos + PDM_FIR_TAPS] = x;
+        f->pos = (f->pos + 1 < PDM_FIR_TAPS) ? f->pos + 1 : 0;
+        f->fir_phase ^= 1;
+        if (f->fir_phase) {
+            continue;
+        }
+        pcm[n++] = pdm_fir(f->fir, &f->line[f->pos]);
+    }
+    return n;
+}
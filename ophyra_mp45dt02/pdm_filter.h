@@ -0,0 +1,54 @@
+/*
+    pdm_filter.h
+
+    PDM to PCM conversion for the MP45DT02 microphone, fixed-point and independent of MicroPython so it can
+    also be built on a PC. Intesc Electronica y Embebidos.
+
+    The filter has three stages, D is the total decimation (16, 32, 64 or 128):
+        -> Stage 1: CIC of order 4 decimating by 8, one lookup per PDM byte in 4 tables instead of
+           running the integrators at the bit rate.
+        -> Stage 2: CIC of order 4 decimating by D/16, 32 bit integrators and combs with wrap around arithmetic.
+        -> Stage 3: FIR of PDM_FIR_TAPS taps in Q15 decimating by 2, low pass up to 0.4 times the output rate
+           with compensation of the droop of the CIC. Two taps per SMLAD on the Cortex-M4.
+    The output is signed 16 bit PCM at the PDM clock divided by D, full scale for a PDM density of 0 or 100%.
+
+    The tables are generated by pdm_filtergen.py, which also has the reference implementation of the filter.
+*/
+
+#ifndef PDM_FILTER_H
+#define PDM_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define PDM_CIC_ORDER   (4)
+#define PDM_FIR_TAPS    (64)
+
+typedef struct _pdm_filter_t {
+    const int16_t *fir;                 // coefficients of stage 3
+    uint8_t r2;                         // decimation of stage 2
+    int8_t shift;                       // right shift from the output of stage 2 to Q14
+    uint8_t phase;                      // PDM bytes since the last output of stage 2
+    uint8_t fir_phase;                  // inputs of stage 3 since its last output
+    uint8_t hist[3];                    // previous PDM bytes, the newest first
+    uint32_t integ[PDM_CIC_ORDER];
+    uint32_t comb[PDM_CIC_ORDER];
+    uint16_t pos;                       // next position of the delay line
+    int16_t line[2 * PDM_FIR_TAPS];     // delay line of stage 3 written twice, always contiguous
+} pdm_filter_t;
+
+/*
+    Clears the state of the filter for a total decimation of 16, 32, 64 or 128.
+    Returns false if the decimation is not supported.
+*/
+bool pdm_filter_init(pdm_filter_t *f, uint16_t decimation);
+
+/*
+    Converts words half-words of PDM data, as received by the I2S peripheral (first bit in the MSB),
+    and stores the PCM samples in pcm. Returns the number of samples, words*16/D when words is a
+    multiple of D/16.
+*/
+size_t pdm_filter_run(pdm_filter_t *f, const uint16_t *pdm, size_t words, int16_t *pcm);
+
+#endif // PDM_FILTER_H
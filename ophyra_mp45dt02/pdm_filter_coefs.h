@@ -0,0 +1,136 @@
+/*
+    pdm_filter_coefs.h
+
+    Tables of pdm_filter.c generated by pdm_filtergen.py, do not edit.
+    Intesc Electronica y Embebidos.
+
+    Only included by pdm_filter.c.
+*/
+
+#if PDM_FIR_TAPS != 64 || PDM_CIC_ORDER != 4
+#error "pdm_filter.h does not match pdm_filter_coefs.h, run pdm_filtergen.py"
+#endif
+
+/*
+    Stage 1: contribution of the PDM byte received j bytes ago (MSB first) to the output of the
+    CIC of order 4 decimating by 8, pdm_cic1[j*256 + byte].
+*/
+static const uint16_t pdm_cic1[]=
+{
+0, 1, 4, 5, 10, 11, 14, 15, 20, 21, 24, 25, 30, 31, 34, 35,
+35, 36, 39, 40, 45, 46, 49, 50, 55, 56, 59, 60, 65, 66, 69, 70,
+56, 57, 60, 61, 66, 67, 70, 71, 76, 77, 80, 81, 86, 87, 90, 91,
+91, 92, 95, 96, 101, 102, 105, 106, 111, 112, 115, 116, 121, 122, 125, 126,
+84, 85, 88, 89, 94, 95, 98, 99, 104, 105, 108, 109, 114, 115, 118, 119,
+119, 120, 123, 124, 129, 130, 133, 134, 139, 140, 143, 144, 149, 150, 153, 154,
+140, 141, 144, 145, 150, 151, 154, 155, 160, 161, 164, 165, 170, 171, 174, 175,
+175, 176, 179, 180, 185, 186, 189, 190, 195, 196, 199, 200, 205, 206, 209, 210,
+120, 121, 124, 125, 130, 131, 134, 135, 140, 141, 144, 145, 150, 151, 154, 155,
+155, 156, 159, 160, 165, 166, 169, 170, 175, 176, 179, 180, 185, 186, 189, 190,
+176, 177, 180, 181, 186, 187, 190, 191, 196, 197, 200, 201, 206, 207, 210, 211,
+211, 212, 215, 216, 221, 222, 225, 226, 231, 232, 235, 236, 241, 242, 245, 246,
+204, 205, 208, 209, 214, 215, 218, 219, 224, 225, 228, 229, 234, 235, 238, 239,
+239, 240, 243, 244, 249, 250, 253, 254, 259, 260, 263, 264, 269, 270, 273, 274,
+260, 261, 264, 265, 270, 271, 274, 275, 280, 281, 284, 285, 290, 291, 294, 295,
+295, 296, 299, 300, 305, 306, 309, 310, 315, 316, 319, 320, 325, 326, 329, 330,
+0, 161, 204, 365, 246, 407, 450, 611, 284, 445, 488, 649, 530, 691, 734, 895,
+315, 476, 519, 680, 561, 722, 765, 926, 599, 760, 803, 964, 845, 1006, 1049, 1210,
+336, 497, 540, 701, 582, 743, 786, 947, 620, 781, 824, 985, 866, 1027, 1070, 1231,
+651, 812, 855, 1016, 897, 1058, 1101, 1262, 935, 1096, 1139, 1300, 1181, 1342, 1385, 1546,
+344, 505, 548, 709, 590, 751, 794, 955, 628, 789, 832, 993, 874, 1035, 1078, 1239,
+659, 820, 863, 1024, 905, 1066, 1109, 1270, 943, 1104, 1147, 1308, 1189, 1350, 1393, 1554,
+680, 841, 884, 1045, 926, 1087, 1130, 1291, 964, 1125, 1168, 1329, 1210, 1371, 1414, 1575,
+995, 1156, 1199, 1360, 1241, 1402, 1445, 1606, 1279, 1440, 1483, 1644, 1525, 1686, 1729, 1890,
+336, 497, 540, 701, 582, 743, 786, 947, 620, 781, 824, 985, 866, 1027, 1070, 1231,
+651, 812, 855, 1016, 897, 1058, 1101, 1262, 935, 1096, 1139, 1300, 1181, 1342, 1385, 1546,
+672, 833, 876, 1037, 918, 1079, 1122, 1283, 956, 1117, 1160, 1321, 1202, 1363, 1406, 1567,
+987, 1148, 1191, 1352, 1233, 1394, 1437, 1598, 1271, 1432, 1475, 1636, 1517, 1678, 1721, 1882,
+680, 841, 884, 1045, 926, 1087, 1130, 1291, 964, 1125, 1168, 1329, 1210, 1371, 1414, 1575,
+995, 1156, 1199, 1360, 1241, 1402, 1445, 1606, 1279, 1440, 1483, 1644, 1525, 1686, 1729, 1890,
+1016, 1177, 1220, 1381, 1262, 1423, 1466, 1627, 1300, 1461, 1504, 1665, 1546, 1707, 1750, 1911,
+1331, 1492, 1535, 1696, 1577, 1738, 1781, 1942, 1615, 1776, 1819, 1980, 1861, 2022, 2065, 2226,
+0, 315, 284, 599, 246, 561, 530, 845, 204, 519, 488, 803, 450, 765, 734, 1049,
+161, 476, 445, 760, 407, 722, 691, 1006, 365, 680, 649, 964, 611, 926, 895, 1210,
+120, 435, 404, 719, 366, 681, 650, 965, 324, 639, 608, 923, 570, 885, 854, 1169,
+281, 596, 565, 880, 527, 842, 811, 1126, 485, 800, 769, 1084, 731, 1046, 1015, 1330,
+84, 399, 368, 683, 330, 645, 614, 929, 288, 603, 572, 887, 534, 849, 818, 1133,
+245, 560, 529, 844, 491, 806, 775, 1090, 449, 764, 733, 1048, 695, 1010, 979, 1294,
+204, 519, 488, 803, 450, 765, 734, 1049, 408, 723, 692, 1007, 654, 969, 938, 1253,
+365, 680, 649, 964, 611, 926, 895, 1210, 569, 884, 853, 1168, 815, 1130, 1099, 1414,
+56, 371, 340, 655, 302, 617, 586, 901, 260, 575, 544, 859, 506, 821, 790, 1105,
+217, 532, 501, 816, 463, 778, 747, 1062, 421, 736, 705, 1020, 667, 982, 951, 1266,
+176, 491, 460, 775, 422, 737, 706, 1021, 380, 695, 664, 979, 626, 941, 910, 1225,
+337, 652, 621, 936, 583, 898, 867, 1182, 541, 856, 825, 1140, 787, 1102, 1071, 1386,
+140, 455, 424, 739, 386, 701, 670, 985, 344, 659, 628, 943, 590, 905, 874, 1189,
+301, 616, 585, 900, 547, 862, 831, 1146, 505, 820, 789, 1104, 751, 1066, 1035, 1350,
+260, 575, 544, 859, 506, 821, 790, 1105, 464, 779, 748, 1063, 710, 1025, 994, 1309,
+421, 736, 705, 1020, 667, 982, 951, 1266, 625, 940, 909, 1224, 871, 1186, 1155, 1470,
+0, 35, 20, 55, 10, 45, 30, 65, 4, 39, 24, 59, 14, 49, 34, 69,
+1, 36, 21, 56, 11, 46, 31, 66, 5, 40, 25, 60, 15, 50, 35, 70,
+0, 35, 20, 55, 10, 45, 30, 65, 4, 39, 24, 59, 14, 49, 34, 69,
+1, 36, 21, 56, 11, 46, 31, 66, 5, 40, 25, 60, 15, 50, 35, 70,
+0, 35, 20, 55, 10, 45, 30, 65, 4, 39, 24, 59, 14, 49, 34, 69,
+1, 36, 21, 56, 11, 46, 31, 66, 5, 40, 25, 60, 15, 50, 35, 70,
+0, 35, 20, 55, 10, 45, 30, 65, 4, 39, 24, 59, 14, 49, 34, 69,
+1, 36, 21, 56, 11, 46, 31, 66, 5, 40, 25, 60, 15, 50, 35, 70,
+0, 35, 20, 55, 10, 45, 30, 65, 4, 39, 24, 59, 14, 49, 34, 69,
+1, 36, 21, 56, 11, 46, 31, 66, 5, 40, 25, 60, 15, 50, 35, 70,
+0, 35, 20, 55, 10, 45, 30, 65, 4, 39, 24, 59, 14, 49, 34, 69,
+1, 36, 21, 56, 11, 46, 31, 66, 5, 40, 25, 60, 15, 50, 35, 70,
+0, 35, 20, 55, 10, 45, 30, 65, 4, 39, 24, 59, 14, 49, 34, 69,
+1, 36, 21, 56, 11, 46, 31, 66, 5, 40, 25, 60, 15, 50, 35, 70,
+0, 35, 20, 55, 10, 45, 30, 65, 4, 39, 24, 59, 14, 49, 34, 69,
+1, 36, 21, 56, 11, 46, 31, 66, 5, 40, 25, 60, 15, 50, 35, 70,
+};
+
+/*
+    Stage 3 for a total decimation of 16: low pass with CIC compensation, Q15, symmetric.
+*/
+static const int16_t pdm_fir_16[]=
+{
+0, 0, 0, 0, -1, 0, 1, 1, 1, 1, -5, -4,
+12, 9, -18, -13, 13, 5, 24, 39, -122, -156, 324, 408,
+-683, -900, 1286, 1883, -2330, -4296, 4394, 16514, 16514, 4394, -4296, -2330,
+1883, 1286, -900, -683, 408, 324, -156, -122, 39, 24, 5, 13,
+-13, -18, 9, 12, -4, -5, 1, 1, 1, 1, 0, -1,
+0, 0, 0, 0,
+};
+
+/*
+    Stage 3 for a total decimation of 32: low pass with CIC compensation, Q15, symmetric.
+*/
+static const int16_t pdm_fir_32[]=
+{
+0, 0, 0, 0, -1, -1, 1, 1, 1, 1, -5, -4,
+12, 10, -18, -13, 13, 5, 24, 39, -123, -157, 325, 409,
+-686, -904, 1291, 1891, -2337, -4316, 4389, 16537, 16537, 4389, -4316, -2337,
+1891, 1291, -904, -686, 409, 325, -157, -123, 39, 24, 5, 13,
+-13, -18, 10, 12, -4, -5, 1, 1, 1, 1, -1, -1,
+0, 0, 0, 0,
+};
+
+/*
+    Stage 3 for a total decimation of 64: low pass with CIC compensation, Q15, symmetric.
+*/
+static const int16_t pdm_fir_64[]=
+{
+0, 0, 0, 0, -1, -1, 1, 1, 1, 1, -5, -4,
+12, 10, -18, -13, 13, 5, 24, 39, -123, -157, 325, 409,
+-686, -904, 1292, 1893, -2338, -4321, 4387, 16543, 16543, 4387, -4321, -2338,
+1893, 1292, -904, -686, 409, 325, -157, -123, 39, 24, 5, 13,
+-13, -18, 10, 12, -4, -5, 1, 1, 1, 1, -1, -1,
+0, 0, 0, 0,
+};
+
+/*
+    Stage 3 for a total decimation of 128: low pass with CIC compensation, Q15, symmetric.
+*/
+static const int16_t pdm_fir_128[]=
+{
+0, 0, 0, 0, -1, -1, 1, 1, 1, 1, -5, -4,
+12, 10, -18, -13, 13, 5, 24, 39, -123, -157, 326, 409,
+-687, -905, 1293, 1894, -2339, -4323, 4387, 16545, 16545, 4387, -4323, -2339,
+1894, 1293, -905, -687, 409, 326, -157, -123, 39, 24, 5, 13,
+-13, -18, 10, 12, -4, -5, 1, 1, 1, 1, -1, -1,
+0, 0, 0, 0,
+};
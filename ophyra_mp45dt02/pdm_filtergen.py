@@ -0,0 +1,372 @@
+#!/usr/bin/env python3
+"""
+    pdm_filtergen.py
+
+    Generates pdm_filter_coefs.h, the tables of the PDM to PCM filter of pdm_filter.c, and is the host
+    reference implementation of that filter. It also generates mp45dt02_profiles.h, the output filters
+    of ophyra_mp45dt02.c for every sample rate.
+    Intesc Electronica y Embebidos.
+
+    Run it from this folder after changing a filter, the generated headers are kept in the repository:
+        python3 pdm_filtergen.py
+    Simulate a sine through a sigma-delta modulator and print the SNR of the float and fixed-point models,
+    then the response of the output filters:
+        python3 pdm_filtergen.py --selftest
+
+    Filter (D is the total decimation, 16 to 128):
+        -> Stage 1: CIC of order 4 decimating by 8, run a byte of PDM at a time with 4 lookup tables.
+        -> Stage 2: CIC of order 4 decimating by D/16 with 32 bit integrators and combs.
+        -> Stage 3: FIR of PDM_FIR_TAPS taps in Q15 decimating by 2. It is a low pass filter up to 0.4 times the
+           output rate that also compensates the droop of the CIC stages, one coefficient set per D.
+
+    Output filters (profiles) of ophyra_mp45dt02.c, cascades of biquads in float designed with the bilinear
+    transform for every rate of RATES:
+        -> FLAT: Butterworth high pass of order 2 at 20 Hz, removes the offset of the microphone.
+        -> VOICE: Butterworth band pass of order 4 from 300 Hz to 3400 Hz.
+        -> NONE: the output of pdm_filter.c as is.
+"""
+
+import math
+import os
+import random
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+CIC_ORDER = 4
+CIC1_R = 8
+FIR_TAPS = 64
+DECIMATIONS = (16, 32, 64, 128)
+PASS = 0.2      # end of the pass band of stage 3, relative to its input rate (0.4 of the output rate)
+STOP = 0.3      # start of the stop band
+
+RATES = (8000, 16000, 32000, 44100)
+# Sections of every profile: (name, [(type, order, cut frequency)])
+PROFILES = (
+    ("NONE", []),
+    ("FLAT", [("high", 2, 20)]),
+    ("VOICE", [("high", 4, 300), ("low", 4, 3400)]),
+)
+
+
+def boxcar_power(r, order):
+    """Impulse response of a CIC of the given order and decimation r."""
+    h = [1]
+    for _ in range(order):
+        out = [0] * (len(h) + r - 1)
+        for i, v in enumerate(h):
+            for k in range(r):
+                out[i + k] += v
+        h = out
+    return h
+
+
+def cic1_tables():
+    """T[j][v]: contribution of the byte v received j bytes ago to the stage 1 output, bits MSB first."""
+    h = boxcar_power(CIC1_R, CIC_ORDER)
+    tables = []
+    for j in range(4):
+        table = []
+        for v in range(256):
+            acc = 0
+            for i in range(8):
+                k = 8 * j + 7 - i
+                if (v >> (7 - i)) & 1 and k < len(h):
+                    acc += h[k]
+            table.append(acc)
+        tables.append(table)
+    return tables
+
+
+def cic_gain(f, r):
+    """Normalized magnitude of a CIC of decimation r at the frequency f relative to its output rate."""
+    if f == 0:
+        return 1.0
+    return abs(math.sin(math.pi * f) / (r * math.sin(math.pi * f / r))) ** CIC_ORDER
+
+
+def bessel_i0(x):
+    s, t, k = 1.0, 1.0, 1
+    while t > 1e-12 * s:
+        t *= (x / (2 * k)) ** 2
+        s += t
+        k += 1
+    return s
+
+
+def fir_design(decimation, taps=FIR_TAPS, beta=7.0, grid=4000):
+    """Linear phase FIR, 1/CIC response in the pass band, 0 in the stop band, Kaiser window."""
+    r = decimation // 2
+    center = (taps - 1) / 2
+
+    def desired(f):
+        if f <= PASS:
+            return 1.0 / cic_gain(f, r)
+        if f >= STOP:
+            return 0.0
+        edge = 1.0 / cic_gain(PASS, r)
+        return edge * 0.5 * (1 + math.cos(math.pi * (f - PASS) / (STOP - PASS)))
+
+    samples = [desired((i + 0.5) * 0.5 / grid) for i in range(grid)]
+    h = []
+    for n in range(taps):
+        acc = 0.0
+        for i, d in enumerate(samples):
+            acc += d * math.cos(2 * math.pi * (i + 0.5) * 0.5 / grid * (n - center))
+        w = bessel_i0(beta * math.sqrt(1 - ((n - center) / center) ** 2)) / bessel_i0(beta)
+        h.append(2 * acc * 0.5 / grid * w)
+    # Unity gain at DC
+    dc = sum(h)
+    return [v / dc for v in h]
+
+
+def q15(h):
+    return [max(-32768, min(32767, int(round(v * 32768)))) for v in h]
+
+
+def cic2_shift(decimation):
+    """Right shift from the stage 2 output to Q14, negative for a left shift."""
+    r2 = decimation // 16
+    return 12 + CIC_ORDER * int(math.log2(r2)) - 14
+
+
+def butterworth(kind, order, fc, fs):
+    """Biquads (b0, b1, b2, a1, a2) of a Butterworth low or high pass of even order, a0 normalized to 1."""
+    w0 = 2 * math.pi * fc / fs
+    cw = math.cos(w0)
+    sections = []
+    for k in range(order // 2):
+        q = 1 / (2 * math.cos(math.pi * (2 * k + 1) / (2 * order)))
+        alpha = math.sin(w0) / (2 * q)
+        a0 = 1 + alpha
+        if kind == "low":
+            b = ((1 - cw) / 2, 1 - cw, (1 - cw) / 2)
+        else:
+            b = ((1 + cw) / 2, -(1 + cw), (1 + cw) / 2)
+        sections.append((b[0] / a0, b[1] / a0, b[2] / a0, -2 * cw / a0, (1 - alpha) / a0))
+    return sections
+
+
+def profile_biquads(sections, fs):
+    out = []
+    for kind, order, fc in sections:
+        out += butterworth(kind, order, fc, fs)
+    return out
+
+
+def biquads_gain(biquads, f, fs):
+    z = complex(math.cos(2 * math.pi * f / fs), -math.sin(2 * math.pi * f / fs))
+    g = 1
+    for b0, b1, b2, a1, a2 in biquads:
+        g *= (b0 + b1 * z + b2 * z * z) / (1 + a1 * z + a2 * z * z)
+    return abs(g)
+
+
+# Reference implementation
+
+def reference_float(bits, decimation, coefs):
+    """Float model: the CIC as the equivalent FIR on the bits (+1/-1), then the FIR decimating by 2."""
+    r = decimation // 2
+    h = boxcar_power(r, CIC_ORDER)
+    gain = float(r ** CIC_ORDER)
+    x = [1.0 if b else -1.0 for b in bits]
+    stage2 = []
+    for m in range(r - 1, len(x), r):
+        acc = 0.0
+        for k, v in enumerate(h):
+            if m - k >= 0:
+                acc += v * x[m - k]
+        stage2.append(acc / gain)
+    out = []
+    for n in range(1, len(stage2), 2):
+        acc = 0.0
+        for k, c in enumerate(coefs):
+            if n - k >= 0:
+                acc += c * stage2[n - k]
+        out.append(acc)
+    return out
+
+
+def reference_fixed(bits, decimation, coefs_q15, tables):
+    """Fixed-point model, bit exact with pdm_filter_run()."""
+    r2 = decimation // 16
+    shift = cic2_shift(decimation)
+    data = []
+    for i in range(0, len(bits) - 7, 8):
+        v = 0
+        for b in bits[i:i + 8]:
+            v = (v << 1) | b
+        data.append(v)
+    hist = [0, 0, 0, 0]
+    integ = [0] * CIC_ORDER
+    comb = [0] * CIC_ORDER
+    phase = 0
+    line = [0] * FIR_TAPS
+    fir_phase = 0
+    out = []
+    mask = 0xFFFFFFFF
+    for v in data:
+        hist = [v] + hist[:3]
+        s1 = 2 * sum(tables[j][hist[j]] for j in range(4)) - 4096
+        acc = s1 & mask
+        for k in range(CIC_ORDER):
+            integ[k] = (integ[k] + acc) & mask
+            acc = integ[k]
+        phase += 1
+        if phase < r2:
+            continue
+        phase = 0
+        for k in range(CIC_ORDER):
+            t = acc
+            acc = (acc - comb[k]) & mask
+            comb[k] = t
+        s2 = acc - (1 << 32) if acc & 0x80000000 else acc
+        s2 = s2 >> shift if shift >= 0 else s2 << -shift
+        s2 = max(-32768, min(32767, s2))
+        line = line[1:] + [s2]
+        fir_phase ^= 1
+        if fir_phase:
+            continue
+        y = sum(c * x for c, x in zip(coefs_q15, line)) >> 14
+        out.append(max(-32768, min(32767, y)))
+    return out
+
+
+def sigma_delta(n, freq, amplitude, seed=1):
+    """Second order sigma-delta modulator, freq relative to the bit rate."""
+    rnd = random.Random(seed)
+    i1 = i2 = 0.0
+    y = 1.0
+    bits = []
+    for t in range(n):
+        x = amplitude * math.sin(2 * math.pi * freq * t) + rnd.uniform(-1e-4, 1e-4)
+        i1 += x - y
+        i2 += i1 - y
+        b = 1 if i2 >= 0 else 0
+        y = 1.0 if b else -1.0
+        bits.append(b)
+    return bits
+
+
+def snr(signal, freq):
+    """SNR in dB of a sine of freq (relative to the sample rate) over a whole number of periods at the end."""
+    cycles = int(len(signal) * 0.75 * freq)
+    s = signal[-int(round(cycles / freq)):]
+    c = [math.cos(2 * math.pi * freq * i) for i in range(len(s))]
+    d = [math.sin(2 * math.pi * freq * i) for i in range(len(s))]
+    mean = sum(s) / len(s)
+    a = 2 * sum((v - mean) * k for v, k in zip(s, c)) / len(s)
+    b = 2 * sum((v - mean) * k for v, k in zip(s, d)) / len(s)
+    fit = [mean + a * k + b * l for k, l in zip(c, d)]
+    noise = sum((v - f) ** 2 for v, f in zip(s, fit)) / len(s)
+    power = (a * a + b * b) / 2
+    return 10 * math.log10(power / noise) if noise > 0 else float("inf")
+
+
+def selftest():
+    tables = cic1_tables()
+    for decimation in DECIMATIONS:
+        coefs = fir_design(decimation)
+        rate = 1.0 / decimation
+        freq = 1000 / 48000 * rate
+        bits = sigma_delta(decimation * 1200, freq, 0.5)
+        f = reference_float(bits, decimation, coefs)
+        q = reference_fixed(bits, decimation, q15(coefs), tables)
+        print("D=%3d  float SNR %5.1f dB  fixed SNR %5.1f dB" % (
+            decimation, snr(f, 1000 / 48000), snr(q, 1000 / 48000)))
+    freqs = (0, 20, 100, 300, 1000, 3400, 3800)
+    print("Output filters, gain in dB at " + " ".join("%d" % f for f in freqs) + " Hz")
+    for name, sections in PROFILES[1:]:
+        for fs in RATES:
+            biquads = profile_biquads(sections, fs)
+            gains = [20 * math.log10(max(biquads_gain(biquads, f, fs), 1e-9)) for f in freqs]
+            print("%-5s %5d  " % (name, fs) + " ".join("%6.1f" % g for g in gains))
+
+
+def emit_array(ctype, name, values, per_line=12):
+    lines = ["static const %s %s[]=\n{" % (ctype, name)]
+    for i in range(0, len(values), per_line):
+        lines.append(", ".join("%d" % v for v in values[i:i + per_line]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    tables = cic1_tables()
+    out = [
+        "/*",
+        "    pdm_filter_coefs.h",
+        "",
+        "    Tables of pdm_filter.c generated by pdm_filtergen.py, do not edit.",
+        "    Intesc Electronica y Embebidos.",
+        "",
+        "    Only included by pdm_filter.c.",
+        "*/",
+        "",
+        "#if PDM_FIR_TAPS != %d || PDM_CIC_ORDER != %d" % (FIR_TAPS, CIC_ORDER),
+        "#error \"pdm_filter.h does not match pdm_filter_coefs.h, run pdm_filtergen.py\"",
+        "#endif",
+        "",
+        "/*",
+        "    Stage 1: contribution of the PDM byte received j bytes ago (MSB first) to the output of the",
+        "    CIC of order %d decimating by %d, pdm_cic1[j*256 + byte]." % (CIC_ORDER, CIC1_R),
+        "*/",
+        emit_array("uint16_t", "pdm_cic1", [v for t in tables for v in t], 16),
+        "",
+    ]
+    for decimation in DECIMATIONS:
+        out += [
+            "/*",
+            "    Stage 3 for a total decimation of %d: low pass with CIC compensation, Q15, symmetric." % decimation,
+            "*/",
+            emit_array("int16_t", "pdm_fir_%d" % decimation, q15(fir_design(decimation))),
+            "",
+        ]
+    with open(os.path.join(HERE, "pdm_filter_coefs.h"), "w") as f:
+        f.write("\n".join(out))
+
+    out = [
+        "/*",
+        "    mp45dt02_profiles.h",
+        "",
+        "    Output filters of ophyra_mp45dt02.c generated by pdm_filtergen.py, do not edit.",
+        "    Intesc Electronica y Embebidos.",
+        "",
+        "    Only included by ophyra_mp45dt02.c after the definition of mp45dt02_biquad_t and mp45dt02_profile_t.",
+        "*/",
+        "",
+    ]
+    entries = []
+    for name, sections in PROFILES:
+        for fs in RATES:
+            biquads = profile_biquads(sections, fs)
+            if not biquads:
+                entries.append("    { %d, PROFILE_%s, 0, NULL }," % (fs, name))
+                continue
+            ident = "profile_%s_%d" % (name.lower(), fs)
+            desc = ", ".join("%s pass of order %d at %d Hz" % s for s in sections)
+            out.append("/*")
+            out.append("    %s at %d Hz: %s." % (name, fs, desc))
+            out.append("*/")
+            out.append("static const mp45dt02_biquad_t %s[]=\n{" % ident)
+            for b in biquads:
+                out.append("    { " + ", ".join("%.9ef" % v for v in b) + " },")
+            out.append("};")
+            out.append("")
+            entries.append("    { %d, PROFILE_%s, %d, %s }," % (fs, name, len(biquads), ident))
+    out.append("static const mp45dt02_profile_t mp45dt02_profiles[]=\n{")
+    out += entries
+    out.append("};")
+    out.append("")
+    out.append("#define PROFILE_BIQUADS_MAX (%d)" % max(
+        len(profile_biquads(sections, RATES[0])) for _, sections in PROFILES))
+    out.append("")
+    with open(os.path.join(HERE, "mp45dt02_profiles.h"), "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    if "--selftest" in sys.argv:
+        selftest()
+    else:
+        main()
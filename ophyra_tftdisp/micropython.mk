@@ -2,6 +2,12 @@ EXAMPLE_MOD_DIR := $(USERMOD_DIR)
 
 # Add all C files to SRC_USERMOD.
 SRC_USERMOD += $(EXAMPLE_MOD_DIR)/ophyra_tftdisp.c
+SRC_USERMOD += $(EXAMPLE_MOD_DIR)/tftdisp_emu.c
+
+# On the unix port the display is replaced by the software model of tftdisp_emu.c.
+ifeq ($(notdir $(CURDIR)),unix)
+CFLAGS_USERMOD += -DTFTDISP_EMULATOR=1
+endif
 
 # We can add our module folder to include paths if needed
 # This is not actually needed in this example.
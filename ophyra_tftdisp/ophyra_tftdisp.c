@@ -19,18 +19,54 @@
     CHANGELOG
 
     -> Update the function write_data() for work drawImg because send a uint32t len
+    -> Add an optional off-screen framebuffer, framebuffer() and show() send only the dirty area.
+    -> Add asynchronous DMA transfers on SPI1 with show(False), busy() and wait().
+    -> write_pixels() sends fills from a reusable scratch buffer instead of one transfer per pixel.
+    -> Characters and text lines with background are rendered in a buffer and sent with a single window.
+    -> Add blit() and blit_buffer() to draw RGB565 images from any object with the buffer protocol.
+    -> Add load_image() to stream BMP and raw RGB565 files from the filesystem, replaces the show_image() draft.
+    -> Add sprite() to draw palette and run length compressed sprites.
+    -> Add hardware scrolling with scroll_area()/scroll() and a console mode with console()/write().
+    -> line() and the new circle, triangle, polygon and rounded rectangle functions draw spans instead of pixels.
+    -> Add partial() and idle() low power modes, power(False) also puts the controller in sleep mode.
+    -> Add the ST7735 software model of tftdisp_emu.c to run the driver on the unix port, with emu_dump() and emu_stats().
+    -> Add font(), text_width() and glyph_cache(): proportional and anti-aliased fonts, scaled text and a cache of rendered characters.
+    -> Add the cell mode with cells(), cell_text() and refresh(), only the changed characters are sent.
+    -> Add the Bar, Gauge and Plot widgets, update() only draws what changes with the new value.
+    -> The constructor takes the SPI bus, prescaler, pins, panel size, offsets, rotation and BGR order, add prescaler() and benchmark().
+    -> Add the band renderer with band(): a display list composed in two small strips, sent with DMA band by band.
+    -> Add read_rect() and screenshot() to read the display RAM with RAMRD, or the framebuffer when it is enabled.
+    -> Add draw_list() to run a packed list of drawing commands in one call, text() no longer copies the string.
+    -> init() runs a table driven sequence with the datasheet delays (about 250 ms instead of 1.9 s),
+       init(rotation, False) runs it in the background with ready().
+    -> Add convert() to convert RGB888, gray or palette and 1 bit images to RGB565 in bulk.
 
 */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "py/runtime.h"
 #include "py/obj.h"
 #include "py/objstr.h"
 #include "py/mphal.h"          
+#include "py/stream.h"
+#include "py/builtin.h"
+
+/*
+    TFTDISP_EMULATOR selects the software ST7735 of tftdisp_emu.c instead of SPI1, to build on the unix port.
+*/
+#ifndef TFTDISP_EMULATOR
+#define TFTDISP_EMULATOR (0)
+#endif
+
+#if TFTDISP_EMULATOR
+#include "tftdisp_emu.h"
+#else
 #include "ports/stm32/spi.h"
-//#include "lib/oofatfs/ff.h"
+#include "dma.h"
+#endif
 /*
     Command Definitions
 */
@@ -55,6 +91,10 @@
 #define CMD_RAMRD   (0x2E)  // Memory Read
 
 #define CMD_PTLAR   (0x30)  // Partial Start/End Address set
+#define CMD_VSCRDEF (0x33)  // Vertical Scrolling Definition
+#define CMD_VSCSAD  (0x37)  // Vertical Scroll Start Address of RAM
+#define CMD_IDMOFF  (0x38)  // Idle mode Off
+#define CMD_IDMON   (0x39)  // Idle mode On (8 colors)
 #define CMD_COLMOD  (0x3A)  // Interface Pixel Format
 #define CMD_MADCTL  (0x36)  // Memory Data Acces Control
 
@@ -91,6 +131,17 @@ const pin_obj_t *Pin_CS=pin_A15;
 const pin_obj_t *Pin_RST=pin_D7;
 const pin_obj_t *Pin_BL=pin_A7;
 
+/*
+    SPI bus of the display, SPI1 unless the constructor selects another one.
+*/
+const spi_t *Spi_TFT=&spi_obj[0];
+
+/*
+    MADCTL of every rotation of init(): landscape, portrait, landscape and portrait turned 180 degrees.
+*/
+#define MADCTL_BGR  (0x08)
+STATIC const uint8_t rotation_madctl[4]={0xA0, 0x00, 0x60, 0xC0};
+
 /*
     TFT color palette definition
 */
@@ -108,6 +159,9 @@ const pin_obj_t *Pin_BL=pin_A7;
     SPI1 Conf
 */
 #define TIMEOUT_SPI     (5000)
+#define DMA_MAX_LEN     (65535)
+#define READ_PRESCALER  (16)        // 5.25 MHz, the ST7735 read cycle is 150 ns
+#define READ_CHUNK      (32)        // pixels received per transfer by read_ram()
 /*
     Font Lib implemented here.
 */
@@ -214,22 +268,70 @@ const uint8_t Font[]=
 0x00, 0x02, 0x01, 0x02, 0x01, 0x00,
 0x00, 0x3C, 0x26, 0x23, 0x26, 0x3C
 };
+
 /*
-    Created a struct for data image for BMP based on ST7735_Driver.h
-    
-    *Don't necessary change the type of var a alternative name is better using name?
+    Description of a bitmap font. The glyphs are stored column by column, every column takes FONT_COL_BYTES()
+    bytes and the pixel of row r is at the bit r*bpp starting from the LSB, like the Font table.
+    The fixed width fonts have no offset and widths tables, all their glyphs are width columns.
+*/
+typedef struct _tftdisp_font_t {
+    const uint8_t *data;
+    const uint16_t *offset;     // Position of every glyph in data
+    const uint8_t *widths;      // Columns of every glyph, 0 if the font does not have it
+    uint8_t width;              // Width of the fixed width fonts, of the widest glyph otherwise
+    uint8_t height;
+    uint8_t first;
+    uint8_t last;
+    uint8_t bpp;                // 1, or 2 in the anti-aliased fonts
+    uint8_t spacing;            // Columns between characters
+} tftdisp_font_t;
+
+#define FONT_COL_BYTES(font)    (((font)->height*(font)->bpp+7)/8)
+
+STATIC const tftdisp_font_t font_6x8=
+{
+    .data=Font,
+    .offset=NULL,
+    .widths=NULL,
+    .width=WIDTH,
+    .height=HEIGHT,
+    .first=START,
+    .last=END,
+    .bpp=1,
+    .spacing=1,
+};
+
+#include "tftdisp_fonts.h"
+
+/*
+    Fonts of font(), in the order of the FONT_ constants of the class.
+*/
+STATIC const tftdisp_font_t *const fonts[]={&font_6x8, &font_prop8, &font_digits24};
+#define FONT_COUNT  (sizeof(fonts)/sizeof(fonts[0]))
+
+/*
+    Entry of the glyph cache, the pixels of a character rendered with the colors of the cache.
 */
-// if use typedef uint8_t U8; may have a problem with the code optimization.
-// typedef struct imgBMPdescription
-// {
-//     uint8_t u8XSize;  // Size in pixels to X axe 
-//     uint8_t u8YSize;  // Size in pixels to Y axe 
-//     uint8_t u8XCursor;// Coordinate in X axe
-//     uint8_t u8YCursor;// Coordinate in Y axe
-//     uint8_t* pu8Img;   // Pointer to Img Data
-// }BMPData;
+#define GLYPH_CACHE_SLOTS   (32)
+typedef struct _glyph_cache_entry_t {
+    const tftdisp_font_t *font;
+    uint32_t offset;            // Position of the pixels in the cache
+    char ch;
+    uint8_t gap;
+    uint8_t sizex;
+    uint8_t sizey;
+} glyph_cache_entry_t;
+
+/*
+    Cell of the cell mode, dirty while the character or the colors changed are not on the display.
+*/
+typedef struct _tftdisp_cell_t {
+    char ch;
+    bool dirty;
+    uint16_t color;
+    uint16_t color_bcknd;
+} tftdisp_cell_t;
 
-// BMPData pstImgdesc;
 /*
     Definition of the data structure arranged for TFT display
 */
@@ -239,10 +341,71 @@ typedef struct _tftdisp_class_obj_t{
     bool power_on;
     bool inverted;
     bool backlight_on;
+    bool idle_on;
+    bool partial_on;
+    uint8_t partial_start;
+    uint8_t partial_end;
     uint8_t margin_row;
     uint8_t margin_col;
     uint8_t width;
     uint8_t height;
+    // Off-screen framebuffer (RGB565 stored in panel byte order) and the
+    // bounding box of the area modified since the last show().
+    uint16_t *fb;
+    bool dirty;
+    uint8_t dirty_x0;
+    uint8_t dirty_y0;
+    uint8_t dirty_x1;
+    uint8_t dirty_y1;
+    // Buffer being sent by an asynchronous blit(), kept here so the GC does not free it.
+    mp_obj_t dma_ref;
+    // The framebuffer is being sent by show(False)
+    bool fb_dma;
+    uint8_t madctl;
+    // Panel geometry of the constructor: size and RAM offsets in rotation 0, rotation used by init()
+    uint8_t panel_width;
+    uint8_t panel_height;
+    uint8_t col_offset;
+    uint8_t row_offset;
+    uint8_t rotation;
+    bool bgr;
+    uint8_t prescaler;
+    // Hardware scrolling area (in panel RAM rows) and console state
+    uint8_t scroll_tfa;
+    uint8_t scroll_vsa;
+    bool console_on;
+    uint8_t con_col;
+    uint8_t con_row;
+    uint8_t con_top;
+    uint16_t con_color;
+    uint16_t con_bcknd;
+    // Font of text() and cache of characters rendered in RGB565 (panel byte order) for one pair of colors
+    uint8_t font;
+    uint8_t font_size;
+    uint8_t *gcache;
+    uint32_t gcache_size;
+    uint32_t gcache_used;
+    uint8_t gcache_count;
+    uint16_t gcache_color;
+    uint16_t gcache_bcknd;
+    glyph_cache_entry_t gcache_entry[GLYPH_CACHE_SLOTS];
+    // Grid of the cell mode
+    tftdisp_cell_t *cells;
+    uint8_t cell_cols;
+    uint8_t cell_rows;
+    uint8_t cell_size;
+    // Band renderer: display list and two strips of band_lines rows, the dirty rectangle is the area of the list
+    uint8_t *dl;
+    uint32_t dl_size;
+    uint32_t dl_used;
+    uint8_t *band_buf;
+    uint8_t band_lines;
+    // List of the buffers recorded by reference, the pointers in dl are not seen by the GC
+    mp_obj_t band_refs;
+    // Initialization sequence in progress: position in init_seq and tick of the next step
+    bool init_busy;
+    uint16_t init_pos;
+    mp_uint_t init_time;
 } tftdisp_class_obj_t;
 
 const mp_obj_type_t tftdisp_class_type;
@@ -253,14 +416,114 @@ STATIC void tftdisp_class_print(const mp_print_t *print, mp_obj_t self_in, mp_pr
     mp_print_str(print, "tftdisp_class()");
 }
 
+/*
+    spi_prescaler() | Intern Function. Configures the SPI bus of the display with a clock of the bus clock/prescaler,
+    prescaler is a power of 2 from 2 to 256.
+*/
+STATIC void spi_prescaler(uint8_t prescaler)
+{
+#if !TFTDISP_EMULATOR
+    static const uint32_t prescalers[]={SPI_BAUDRATEPRESCALER_2, SPI_BAUDRATEPRESCALER_4, SPI_BAUDRATEPRESCALER_8,
+        SPI_BAUDRATEPRESCALER_16, SPI_BAUDRATEPRESCALER_32, SPI_BAUDRATEPRESCALER_64, SPI_BAUDRATEPRESCALER_128,
+        SPI_BAUDRATEPRESCALER_256};
+    uint8_t i=0;
+    while(i<7 && (2<<i)<prescaler)
+    {
+        i++;
+    }
+    // SPI communication settings
+    SPI_InitTypeDef *init = &Spi_TFT->spi->Init;
+    init->Mode = SPI_MODE_MASTER;
+    init->BaudRatePrescaler = prescalers[i];
+    init->CLKPolarity = SPI_POLARITY_HIGH;
+    init->CLKPhase = SPI_PHASE_2EDGE;
+    init->Direction = SPI_DIRECTION_2LINES;
+    init->DataSize = SPI_DATASIZE_8BIT;
+    init->NSS = SPI_NSS_SOFT;
+    init->FirstBit = SPI_FIRSTBIT_MSB;
+    init->TIMode = SPI_TIMODE_DISABLED;
+    init->CRCCalculation = SPI_CRCCALCULATION_DISABLED;
+    init->CRCPolynomial = 0;
+    spi_init(Spi_TFT,false);
+#endif
+}
+
 /*
     make_new: Class constructor. This function is invoked when the Micropython user types:
         ST7735()
+    All the arguments are optional keywords, the default values are the display of the Ophyra board:
+        -> spi SPI bus, 1.
+        -> prescaler SPI clock divider of the bus clock, 2 to 256 (power of 2), 4.
+        -> dc, cs, rst, bl pins of the display, D6, A15, D7, A7.
+        -> width, height size of the panel in rotation 0 (landscape), 160x128.
+        -> col_offset, row_offset position of the panel in the RAM of the controller in rotation 0,
+           the green and red tab variants of the ST7735 need different offsets (for example 2 and 1).
+        -> rotation orientation used by init() without arguments, 0 to 3.
+        -> bgr True for the panels with blue and red exchanged.
+    Example in uPython:
+        tft=ophyra_tftdisp.ST7735(prescaler=2, width=160, height=128, col_offset=2, row_offset=1, bgr=True)
+        tft.init()
 */
-STATIC mp_obj_t tftdisp_class_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+STATIC mp_obj_t tftdisp_class_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_spi, ARG_prescaler, ARG_dc, ARG_cs, ARG_rst, ARG_bl, ARG_width, ARG_height, ARG_col_offset, ARG_row_offset, ARG_rotation, ARG_bgr };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_spi, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_prescaler, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 4} },
+        { MP_QSTR_dc, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_cs, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_rst, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_bl, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_width, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 160} },
+        { MP_QSTR_height, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 128} },
+        { MP_QSTR_col_offset, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_row_offset, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_rotation, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_bgr, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_int_t prescaler=args[ARG_prescaler].u_int;
+    if(prescaler<2 || prescaler>256 || (prescaler&(prescaler-1))!=0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("prescaler must be a power of 2 from 2 to 256"));
+    }
+    if(args[ARG_width].u_int<1 || args[ARG_width].u_int>162 || args[ARG_height].u_int<1 || args[ARG_height].u_int>162
+        || args[ARG_col_offset].u_int<0 || args[ARG_col_offset].u_int>161 || args[ARG_row_offset].u_int<0 || args[ARG_row_offset].u_int>161)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid panel size or offset"));
+    }
+    if(args[ARG_rotation].u_int<0 || args[ARG_rotation].u_int>3)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("rotation must be 0 to 3"));
+    }
+
     tftdisp_class_obj_t *self = m_new_obj(tftdisp_class_obj_t);
     self->base.type = &tftdisp_class_type;
 
+#if !TFTDISP_EMULATOR
+    if(args[ARG_spi].u_obj!=MP_OBJ_NULL)
+    {
+        Spi_TFT=&spi_obj[spi_find_index(args[ARG_spi].u_obj)-1];
+    }
+    if(args[ARG_dc].u_obj!=MP_OBJ_NULL)
+    {
+        Pin_DC=pin_find(args[ARG_dc].u_obj);
+    }
+    if(args[ARG_cs].u_obj!=MP_OBJ_NULL)
+    {
+        Pin_CS=pin_find(args[ARG_cs].u_obj);
+    }
+    if(args[ARG_rst].u_obj!=MP_OBJ_NULL)
+    {
+        Pin_RST=pin_find(args[ARG_rst].u_obj);
+    }
+    if(args[ARG_bl].u_obj!=MP_OBJ_NULL)
+    {
+        Pin_BL=pin_find(args[ARG_bl].u_obj);
+    }
+#endif
+
     //Definition of the use of the working pins for the TFT  
     mp_hal_pin_config(Pin_DC, MP_HAL_PIN_MODE_OUTPUT, MP_HAL_PIN_PULL_DOWN,0);
     mp_hal_pin_config(Pin_CS, MP_HAL_PIN_MODE_OUTPUT, MP_HAL_PIN_PULL_DOWN,0);
@@ -271,31 +534,108 @@ STATIC mp_obj_t tftdisp_class_make_new(const mp_obj_type_t *type, size_t n_args,
     self->power_on=true;
     self->inverted=false;
     self->backlight_on=true;
-    //Initialization of the TFT display columns and rows
-    self->margin_row=0;
-    self->margin_col=0;
-    self->spi=&spi_obj[0];
-    // SPI communication settings
-    //spi_set_params(&spi_obj[0], PRESCALE, BAUDRATE, POLARITY, PHASE, BITS, FIRSTBIT);
-    SPI_InitTypeDef *init = &self->spi->spi->Init;
-    init->Mode = SPI_MODE_MASTER;
-    init->BaudRatePrescaler = SPI_BAUDRATEPRESCALER_4;
-    init->CLKPolarity = SPI_POLARITY_HIGH;
-    init->CLKPhase = SPI_PHASE_2EDGE;
-    init->Direction = SPI_DIRECTION_2LINES;
-    init->DataSize = SPI_DATASIZE_8BIT;
-    init->NSS = SPI_NSS_SOFT;
-    init->FirstBit = SPI_FIRSTBIT_MSB;
-    init->TIMode = SPI_TIMODE_DISABLED;
-    init->CRCCalculation = SPI_CRCCALCULATION_DISABLED;
-    init->CRCPolynomial = 0;
-    spi_init(self->spi,false);
+    self->idle_on=false;
+    self->partial_on=false;
+    //Panel geometry, init() applies it to the TFT display columns and rows
+    self->panel_width=args[ARG_width].u_int;
+    self->panel_height=args[ARG_height].u_int;
+    self->col_offset=args[ARG_col_offset].u_int;
+    self->row_offset=args[ARG_row_offset].u_int;
+    self->rotation=args[ARG_rotation].u_int;
+    self->bgr=args[ARG_bgr].u_bool;
+    self->margin_row=self->row_offset;
+    self->margin_col=self->col_offset;
+    self->width=self->panel_width;
+    self->height=self->panel_height;
+    //The framebuffer is disabled until the user calls framebuffer(True)
+    self->fb=NULL;
+    self->dirty=false;
+    self->dma_ref=MP_OBJ_NULL;
+    self->fb_dma=false;
+    self->madctl=0xA0;
+    self->console_on=false;
+    self->font=0;
+    self->font_size=1;
+    self->gcache=NULL;
+    self->gcache_size=0;
+    self->gcache_used=0;
+    self->gcache_count=0;
+    self->cells=NULL;
+    self->dl=NULL;
+    self->band_refs=MP_OBJ_NULL;
+    self->band_buf=NULL;
+    self->band_lines=0;
+    self->init_busy=false;
+    self->spi=Spi_TFT;
+    self->prescaler=prescaler;
+    spi_prescaler(prescaler);
 
     return MP_OBJ_FROM_PTR(self);
 }
 
 //  Here Intern Functions
 
+#if TFTDISP_EMULATOR
+/*
+    The emulator has no DMA, the asynchronous transfers are done before write_data_dma() returns.
+*/
+STATIC bool dma_busy(void)
+{
+    return false;
+}
+
+STATIC void dma_wait(void)
+{
+}
+#else
+/*
+    DMA state of the asynchronous transfers on SPI1.
+    Only one transfer can be on the wire at a time, every function that uses the bus waits for it first.
+*/
+STATIC DMA_HandleTypeDef tft_dma;
+STATIC bool tft_dma_active=false;
+
+/*
+    dma_busy() Internal function | Returns true while an asynchronous transfer is still running.
+    When the transfer has finished it releases the DMA stream and the CS pin.
+*/
+STATIC bool dma_busy(void)
+{
+    if(!tft_dma_active)
+    {
+        return false;
+    }
+    if(HAL_SPI_GetState(Spi_TFT->spi)!=HAL_SPI_STATE_READY)
+    {
+        return true;
+    }
+    dma_deinit(Spi_TFT->tx_dma_descr);
+    mp_hal_pin_high(Pin_CS);
+    tft_dma_active=false;
+    return false;
+}
+
+/*
+    dma_wait() Internal function | Blocks until the asynchronous transfer in progress (if any) has finished.
+*/
+STATIC void dma_wait(void)
+{
+    uint32_t t_start=HAL_GetTick();
+    while(dma_busy())
+    {
+        if(HAL_GetTick()-t_start>=TIMEOUT_SPI)
+        {
+            HAL_SPI_Abort(Spi_TFT->spi);
+            dma_deinit(Spi_TFT->tx_dma_descr);
+            mp_hal_pin_high(Pin_CS);
+            tft_dma_active=false;
+            mp_raise_OSError(MP_ETIMEDOUT);
+        }
+        MICROPY_EVENT_POLL_HOOK
+    }
+}
+#endif
+
 /*
     write_cmd() Internal function | It is used to communicate with the TFT screen through preset commands, which are used to configure the TFT prior to its operation.
     which are used to configure the TFT prior to its operation.
@@ -304,11 +644,12 @@ STATIC mp_obj_t tftdisp_class_make_new(const mp_obj_type_t *type, size_t n_args,
 */
 STATIC void write_cmd(int cmd)
 {
+    dma_wait();
     mp_hal_pin_low(Pin_DC);
     mp_hal_pin_low(Pin_CS);
     //We define a space of size 1 byte
     uint8_t aux[1]={(uint8_t)cmd};
-    spi_transfer(&spi_obj[0],1, aux, NULL, TIMEOUT_SPI);
+    spi_transfer(Spi_TFT,1, aux, NULL, TIMEOUT_SPI);
 
     mp_hal_pin_high(Pin_CS);
 }
@@ -321,13 +662,145 @@ STATIC void write_cmd(int cmd)
 */
 STATIC void write_data( uint8_t *data, size_t len)
 {
+    dma_wait();
     mp_hal_pin_high(Pin_DC);
     mp_hal_pin_low(Pin_CS);
     //We measure the size of the array with sizeof() to know the size in bytes.
-    spi_transfer(&spi_obj[0],len, data, NULL, TIMEOUT_SPI);
+    spi_transfer(Spi_TFT,len, data, NULL, TIMEOUT_SPI);
 
     mp_hal_pin_high(Pin_CS);
 }
+
+/*
+    write_data_dma() Internal function | Starts sending a buffer to the display with DMA and returns without waiting.
+    The buffer must stay alive and unchanged until dma_busy() returns false.
+    Transfers longer than DMA_MAX_LEN send the first part blocking and only the last part asynchronously.
+*/
+STATIC void write_data_dma(const uint8_t *data, size_t len)
+{
+#if TFTDISP_EMULATOR
+    write_data((uint8_t *)data, len);
+#else
+    dma_wait();
+    const spi_t *spi=Spi_TFT;
+    mp_hal_pin_high(Pin_DC);
+    mp_hal_pin_low(Pin_CS);
+    while(len>DMA_MAX_LEN)
+    {
+        spi_transfer(spi, DMA_MAX_LEN, data, NULL, TIMEOUT_SPI);
+        data+=DMA_MAX_LEN;
+        len-=DMA_MAX_LEN;
+    }
+    dma_init(&tft_dma, spi->tx_dma_descr, DMA_MEMORY_TO_PERIPH, spi->spi);
+    spi->spi->hdmatx=&tft_dma;
+    spi->spi->hdmarx=NULL;
+    MP_HAL_CLEAN_DCACHE(data, len);
+    if(HAL_SPI_Transmit_DMA(spi->spi, (uint8_t *)data, len)!=HAL_OK)
+    {
+        dma_deinit(spi->tx_dma_descr);
+        mp_hal_pin_high(Pin_CS);
+        mp_raise_OSError(MP_EIO);
+    }
+    tft_dma_active=true;
+#endif
+}
+
+/*
+    Initialization sequence of the ST7735, run by init_run(). Every entry is a command, the number of parameters
+    (ORed with INIT_DELAY when a delay in ms follows the parameters) and the parameters. The delays are the
+    datasheet minimums: 120 ms after the hardware reset and after SLPOUT. INIT_RST is not a command, it pulses
+    the RST pin. The orientation (MADCTL) depends on the object and is sent after the table.
+*/
+#define INIT_RST    (0xFF)
+#define INIT_DELAY  (0x80)
+
+STATIC const uint8_t init_seq[]=
+{
+    INIT_RST, INIT_DELAY, 120,
+    CMD_SLPOUT, INIT_DELAY, 120,
+    CMD_FRMCTR1, 3, 0x01, 0x2C, 0x2D,
+    CMD_FRMCTR2, 6, 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D,
+    CMD_INVCTR, 1, 0x07,
+    CMD_PWCTR1, 3, 0xA2, 0x02, 0x84,
+    CMD_PWCTR2, 1, 0xC5,
+    CMD_PWCTR3, 2, 0x8A, 0x00,
+    CMD_PWCTR4, 2, 0x8A, 0x2A,
+    CMD_PWCTR5, 2, 0x8A, 0xEE,
+    CMD_VMCTR1, 1, 0x0E,
+    CMD_INVOFF, 0,
+    CMD_COLMOD, 1, 0x05,
+    CMD_CASET, 4, 0x00, 0x01, 0x00, 127,
+    CMD_RASET, 4, 0x00, 0x01, 0x00, 159,
+    CMD_GMCTRP1, 16, 0x02, 0x1c, 0x07, 0x12, 0x37, 0x32, 0x29, 0x2d, 0x29, 0x25, 0x2b, 0x39, 0x00, 0x01, 0x03, 0x10,
+    CMD_GMCTRN1, 16, 0x03, 0x1d, 0x07, 0x06, 0x2e, 0x2c, 0x29, 0x2d, 0x2e, 0x2e, 0x37, 0x3f, 0x00, 0x00, 0x02, 0x10,
+    CMD_NORON, 0,
+    CMD_DISPON, 0,
+};
+
+/*
+    init_run() | Intern Function. Runs the steps of the initialization sequence whose delay has expired.
+    With block it waits for the delays and finishes the sequence, otherwise it returns at the first pending delay.
+    Returns true when the display is initialized.
+*/
+STATIC bool init_run(tftdisp_class_obj_t *self, bool block)
+{
+    while(self->init_busy)
+    {
+        mp_int_t wait=(mp_int_t)(self->init_time-mp_hal_ticks_ms());
+        if(wait>0)
+        {
+            if(!block)
+            {
+                return false;
+            }
+            mp_hal_delay_ms(wait);
+        }
+        if(self->init_pos>=sizeof(init_seq))
+        {
+            write_cmd(CMD_MADCTL);
+            write_data(&self->madctl, 1);
+            self->init_busy=false;
+            break;
+        }
+        const uint8_t *p=&init_seq[self->init_pos];
+        uint8_t n=p[1]&~INIT_DELAY;
+        if(p[0]==INIT_RST)
+        {
+            mp_hal_pin_low(Pin_DC);
+            mp_hal_pin_low(Pin_RST);
+            mp_hal_delay_us(20);
+            mp_hal_pin_high(Pin_RST);
+        }
+        else
+        {
+            write_cmd(p[0]);
+            if(n>0)
+            {
+                write_data((uint8_t *)&p[2], n);
+            }
+        }
+        self->init_pos+=2+n;
+        if(p[1]&INIT_DELAY)
+        {
+            self->init_time=mp_hal_ticks_ms()+init_seq[self->init_pos];
+            self->init_pos++;
+        }
+    }
+    return true;
+}
+
+/*
+    init_finish() | Intern Function. Completes an init() still running in the background before a command is sent to the
+    panel, otherwise the rest of the sequence would undo it.
+*/
+STATIC void init_finish(tftdisp_class_obj_t *self)
+{
+    if(self->init_busy)
+    {
+        init_run(self, true);
+    }
+}
+
 /*
     set_window() intern function | Defines settings for the rows and columns in the screen display so that when a pixel or character is placed it is preset.
     when a pixel or character? is placed it is preset.
@@ -342,6 +815,8 @@ STATIC void set_window(mp_obj_t self_in, uint8_t x0, uint8_t y0, uint8_t x1, uin
     //Any pixels written to the display will start from this area. 
 
     tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    //Drawing before the end of a background init() finishes it first
+    init_finish(self);
     // set row XSTART/XEND
     write_cmd(CMD_RASET);
     uint8_t bytes_send[]={0x00, y0 + self->margin_row, 0x00, y1 + self->margin_row};
@@ -357,102 +832,285 @@ STATIC void set_window(mp_obj_t self_in, uint8_t x0, uint8_t y0, uint8_t x1, uin
 }
 
 /*
-    reset() Hard reset the display.
+    Scratch buffer of the fill engine. It holds FILL_BUF_PIXELS copies of the last color used
+    (1 KB, a bit more than three 160 pixel lines) so fills are sent in large transfers.
 */
-STATIC void reset(void)
-{
-    mp_hal_pin_low(Pin_DC);
-    mp_hal_pin_high(Pin_RST);
-    mp_hal_delay_ms(500);
-    mp_hal_pin_low(Pin_RST);
-    mp_hal_delay_ms(500);
-    mp_hal_pin_high(Pin_RST);
-    mp_hal_delay_ms(500);
-}
+#define FILL_BUF_PIXELS (512)
+STATIC uint8_t fill_buf[FILL_BUF_PIXELS*2];
+STATIC uint16_t fill_buf_color;
+STATIC uint16_t fill_buf_count=0;
 
 /*
     write_pixels() intern function | Used to draw a pixel on the display
     so that all the functions need this function to draw the desired pixels on the screen
     the desired pixels on the screen by returning the size of pixels to be drawn and the color.
     and the color.
+    The color is expanded once into fill_buf, which is then sent as many times as needed,
+    so clearing a 160x128 display takes 40 transfers instead of one per pixel.
 */
 
-STATIC void write_pixels(uint16_t count, uint16_t color)
+STATIC void write_pixels(uint32_t count, uint16_t color)
 {
         //Write pixels to the display.
         //count - total number of pixels
         //color - 16-bit RGB value
-    uint8_t data_transfer[2]={(uint8_t)(color>>8), (uint8_t)(color&0xFF)};
+    uint16_t needed=(count<FILL_BUF_PIXELS) ? count : FILL_BUF_PIXELS;
+    if(fill_buf_color!=color || fill_buf_count<needed)
+    {
+        //Only expand the color again when it changes or more pixels are needed
+        if(fill_buf_color!=color)
+        {
+            fill_buf_count=0;
+        }
+        for(uint16_t i=fill_buf_count; i<needed; i++)
+        {
+            fill_buf[2*i]=(uint8_t)(color>>8);
+            fill_buf[2*i+1]=(uint8_t)(color&0xFF);
+        }
+        fill_buf_color=color;
+        fill_buf_count=needed;
+    }
+    dma_wait();
     mp_hal_pin_high(Pin_DC);
     mp_hal_pin_low(Pin_CS);
-    for(uint16_t i=0; i<count;i++)
-    {   
-        //We send the color of the size of 2 bytes if the color is 16 bits.
-        //Always 2 bytes are sent to this function
-        spi_transfer(&spi_obj[0],2,data_transfer, NULL, TIMEOUT_SPI);
+    while(count>0)
+    {
+        uint16_t chunk=(count<FILL_BUF_PIXELS) ? count : FILL_BUF_PIXELS;
+        spi_transfer(Spi_TFT, chunk*2, fill_buf, NULL, TIMEOUT_SPI);
+        count-=chunk;
     }
     mp_hal_pin_high(Pin_CS);
 }
 /*
-    hline() | Intern Function. This function is used internally to create horizontal lines on the TFT display.
-    horizontal lines on the TFT display.
-    It accepts primitive parameters as it is for internal use.
+    The drawing goes to memory instead of the display: framebuffer or display list of the band renderer.
+*/
+#define OFFSCREEN(self)     ((self)->fb!=NULL || (self)->dl!=NULL)
+
+/*
+    ram_row_offset() | Intern Function. Offset of the panel RAM rows used by VSCSAD and PTLAR. MV exchanges the axes,
+    then the RAM rows run along the columns of the screen.
 */
-STATIC mp_obj_t hline(mp_obj_t self_in, uint8_t x, uint8_t y, uint8_t w, uint16_t color)
+STATIC uint8_t ram_row_offset(tftdisp_class_obj_t *self)
 {
-    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    if(x>=self->width || y>=self->height)
+    return (self->madctl&0x20) ? self->margin_col : self->margin_row;
+}
+
+/*
+    fb_mark_dirty() | Intern Function. Grows the dirty rectangle of the framebuffer so that it
+    also covers the area (x0, y0)-(x1, y1). show() only sends the resulting union to the display.
+*/
+STATIC void fb_mark_dirty(tftdisp_class_obj_t *self, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+    if(!self->dirty)
     {
-        return mp_const_none;
+        self->dirty_x0=x0;
+        self->dirty_y0=y0;
+        self->dirty_x1=x1;
+        self->dirty_y1=y1;
+        self->dirty=true;
+        return;
     }
-    set_window(self, x, y, x+w-1, y);
-    write_pixels(x+w-1, color);
-    return mp_const_none;
+    if(x0<self->dirty_x0) self->dirty_x0=x0;
+    if(y0<self->dirty_y0) self->dirty_y0=y0;
+    if(x1>self->dirty_x1) self->dirty_x1=x1;
+    if(y1>self->dirty_y1) self->dirty_y1=y1;
 }
 
 /*
-    vline() | Intern function. This function is for internal use for the
-    creation of vertical lines in the TFT display, in this way primitive parameters are
-    primitive parameters are sent as it is for internal use.
+    fb_sync() | Intern Function. Waits for the transfer started by show(False) before the framebuffer is written,
+    the DMA reads the pixels straight from it.
 */
-STATIC mp_obj_t vline(mp_obj_t self_in, uint8_t x, uint8_t y, uint8_t h, uint16_t color)
+STATIC void fb_sync(tftdisp_class_obj_t *self)
 {
-    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    if(x>=self->width || y>=self->height)
+    if(self->fb_dma)
     {
-        return mp_const_none;
+        dma_wait();
+        self->fb_dma=false;
     }
-    if((y+h-1)>=self->height)
+}
+
+/*
+    fb_fill() | Intern Function. Fills an already clipped area of the framebuffer with a color.
+    The pixels are stored with the high byte first, which is the order the ST7735 expects,
+    so show() can send the memory without any conversion.
+*/
+STATIC void fb_fill(tftdisp_class_obj_t *self, uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint16_t color)
+{
+    uint16_t swapped=(uint16_t)((color>>8) | (color<<8));
+    fb_sync(self);
+    for(uint8_t j=0; j<h; j++)
     {
-        h=self->height-y;
+        uint16_t *row=&self->fb[(y+j)*self->width + x];
+        for(uint8_t i=0; i<w; i++)
+        {
+            row[i]=swapped;
+        }
     }
-    set_window(self, x, y, x, y+h-1);
-    write_pixels(y+h-1, color);
-    return mp_const_none;
+    fb_mark_dirty(self, x, y, x+w-1, y+h-1);
+}
+
+/*
+    Band renderer. While it is enabled the drawing functions append their primitives to a display list instead of
+    drawing, show() renders the list in strips of band_lines rows and sends every strip with DMA while the next one
+    is rendered in the other strip buffer. Every primitive is clipped to the display when it is recorded.
+        BAND_FILL: op, x, y, w, h, color (high byte first).
+        BAND_BLIT: op, x, y, w, h, flags, stride (2 bytes), and the pixels (w*h*2 bytes) or a pointer to them with BAND_REF.
+*/
+#define BAND_FILL   (0)
+#define BAND_BLIT   (1)
+#define BAND_SWAP   (0x01)
+#define BAND_REF    (0x02)
+#define BAND_LIST_SIZE  (1024)
+
+STATIC void band_free(tftdisp_class_obj_t *self)
+{
+    if(self->dl==NULL)
+    {
+        return;
+    }
+    //The strips can not be released while DMA is still reading them
+    dma_wait();
+    m_del(uint8_t, self->dl, self->dl_size);
+    m_del(uint8_t, self->band_buf, 2*self->width*self->band_lines*2);
+    self->dl=NULL;
+    self->band_buf=NULL;
+    self->band_lines=0;
+    self->band_refs=MP_OBJ_NULL;
+    self->dirty=false;
+}
+
+/*
+    band_reserve() | Intern Function. Returns space for n bytes at the end of the display list, which grows when it is full.
+*/
+STATIC uint8_t *band_reserve(tftdisp_class_obj_t *self, uint32_t n)
+{
+    if(self->dl_used+n>self->dl_size)
+    {
+        uint32_t size=self->dl_size*2;
+        while(self->dl_used+n>size)
+        {
+            size*=2;
+        }
+        self->dl=m_renew(uint8_t, self->dl, self->dl_size, size);
+        self->dl_size=size;
+    }
+    uint8_t *p=&self->dl[self->dl_used];
+    self->dl_used+=n;
+    return p;
+}
+
+/*
+    band_fill() | Intern Function. Records an already clipped filled rectangle.
+*/
+STATIC void band_fill(tftdisp_class_obj_t *self, uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint16_t color)
+{
+    if(w==self->width && h==self->height)
+    {
+        //Covers the whole display, the previous primitives and their buffers are not needed anymore
+        self->dl_used=0;
+        self->band_refs=MP_OBJ_NULL;
+    }
+    uint8_t *p=band_reserve(self, 7);
+    p[0]=BAND_FILL;
+    p[1]=x;
+    p[2]=y;
+    p[3]=w;
+    p[4]=h;
+    p[5]=(uint8_t)(color>>8);
+    p[6]=(uint8_t)(color&0xFF);
+    fb_mark_dirty(self, x, y, x+w-1, y+h-1);
+}
+
+/*
+    band_blit() | Intern Function. Records a w*h RGB565 image at (x, y) clipped to the display. The pixels are copied
+    to the list unless ref is true, then the buffer must not change until show() and the caller keeps its object
+    in band_refs.
+*/
+STATIC void band_blit(tftdisp_class_obj_t *self, mp_int_t x, mp_int_t y, mp_int_t w, mp_int_t h, const uint8_t *data, bool swap, bool ref)
+{
+    mp_int_t x0=(x<0) ? 0 : x;
+    mp_int_t y0=(y<0) ? 0 : y;
+    mp_int_t x1=(x+w>self->width) ? self->width : x+w;
+    mp_int_t y1=(y+h>self->height) ? self->height : y+h;
+    if(x0>=x1 || y0>=y1)
+    {
+        return;
+    }
+    uint16_t cw=x1-x0;
+    uint16_t ch=y1-y0;
+    const uint8_t *src=data + ((y0-y)*w + (x0-x))*2;
+    uint8_t *p=band_reserve(self, 8 + (ref ? sizeof(src) : (uint32_t)cw*ch*2));
+    p[0]=BAND_BLIT;
+    p[1]=x0;
+    p[2]=y0;
+    p[3]=cw;
+    p[4]=ch;
+    if(ref)
+    {
+        p[5]=BAND_REF | (swap ? BAND_SWAP : 0);
+        p[6]=(uint8_t)((w*2)&0xFF);
+        p[7]=(uint8_t)((w*2)>>8);
+        memcpy(&p[8], &src, sizeof(src));
+    }
+    else
+    {
+        //Copied in panel byte order
+        p[5]=0;
+        p[6]=(uint8_t)((cw*2)&0xFF);
+        p[7]=(uint8_t)((cw*2)>>8);
+        uint8_t *dst=&p[8];
+        for(uint16_t j=0; j<ch; j++)
+        {
+            for(uint16_t i=0; i<cw; i++)
+            {
+                dst[2*i]=swap ? src[2*i+1] : src[2*i];
+                dst[2*i+1]=swap ? src[2*i] : src[2*i+1];
+            }
+            dst+=cw*2;
+            src+=w*2;
+        }
+    }
+    fb_mark_dirty(self, x0, y0, x1-1, y1-1);
 }
 
 /*
     pixel0(x, y, color) | Intern Function is used to draw a single individual pixel on the TFT screen
     so that public use python functions can send primitive data, 
     to speed up the plotting process on the TFT display.
-    
+    When the framebuffer is enabled the pixel is only written to RAM.
 */
 STATIC void pixel0(mp_obj_t self_in, uint8_t x, uint8_t y, uint16_t color )
 {
     //Draw a single pixel0 on the display with given color.
     tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    set_window(self, x, y, x+1, y+1);
+    if(x>=self->width || y>=self->height)
+    {
+        return;
+    }
+    if(self->dl!=NULL)
+    {
+        band_fill(self, x, y, 1, 1, color);
+        return;
+    }
+    if(self->fb!=NULL)
+    {
+        fb_sync(self);
+        self->fb[y*self->width + x]=(uint16_t)((color>>8) | (color<<8));
+        fb_mark_dirty(self, x, y, x, y);
+        return;
+    }
+    set_window(self, x, y, x, y);
     write_pixels(1,color);
 }
 /*
     rect_int | Intern Function is the same with function rect() only receive primitive
-    params.
+    params. When the framebuffer is enabled the rectangle is only drawn in RAM.
 */
 STATIC mp_obj_t rect_int(mp_obj_t self_in, uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint16_t color)
 {
     //Draw a rectangle with specified coordinates/size and fill with color.
     tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    if(x>=self->width || y>=self->height)
+    if(x>=self->width || y>=self->height || w==0 || h==0)
     {
         return mp_const_none;
     }
@@ -464,159 +1122,216 @@ STATIC mp_obj_t rect_int(mp_obj_t self_in, uint8_t x, uint8_t y, uint8_t w, uint
     {
         h=self->height-y;
     }
+    if(self->dl!=NULL)
+    {
+        band_fill(self, x, y, w, h, color);
+        return mp_const_none;
+    }
+    if(self->fb!=NULL)
+    {
+        fb_fill(self, x, y, w, h, color);
+        return mp_const_none;
+    }
     set_window(self, x, y, x+w-1, y+h-1);
     write_pixels((w*h), color);
     return mp_const_none;
 }
 /*
-    drawImg() | Intern Function for put a Img in screen.
-*/
-// STATIC void drawImg(mp_obj_t self_in, BMPData* pstImgDesc)
-// {
-//     tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
-//     set_window(self, pstImgDesc->u8XCursor, pstImgDesc->u8YCursor, pstImgDesc->u8XSize, pstImgDesc->u8YSize);
-//     write_data(pstImgDesc->pu8Img, pstImgDesc->u8XSize * pstImgDesc->u8YSize * 3);
-// }
-
-/*
-    ST7735() is the function that initializes the TFT screen is the equivalent of:
-        ST7735().init()
-    In this case there will be a change in which the function will be invoked as follows:
-        ST7735().init(True) or ST7735().init(1)
-
+    fill_rect() | Intern Function. Same as rect_int() but with signed coordinates, the parts of the
+    rectangle outside the display are clipped. Every span of the shape rasterizers ends here.
 */
-STATIC mp_obj_t st7735_init(size_t n_args, const mp_obj_t *args)
+STATIC void fill_rect(tftdisp_class_obj_t *self, mp_int_t x, mp_int_t y, mp_int_t w, mp_int_t h, uint16_t color)
 {
-    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
-    uint8_t orient=0;
-    if(args[1])
+    if(x<0)
     {
-        orient=mp_obj_get_int(args[1]);
+        w+=x;
+        x=0;
     }
-    //mp_obj_is_bool(orient);
-    //First hard reset 
-    reset(); //function here
-    write_cmd(CMD_SWRESET);
-
-    mp_hal_delay_ms(150);
-    write_cmd(CMD_SLPOUT);
-
-    mp_hal_delay_ms(255);
-
-    //Data transmission and delays optimization
-    write_cmd(CMD_FRMCTR1);
-
-    
-    uint8_t data_set3[]={0x01, 0x2C, 0x2D};
-    write_data(data_set3, sizeof(data_set3));
-
-    write_cmd(CMD_FRMCTR2);
-
-    uint8_t data_set6[]={0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D};
-    write_data(data_set6, sizeof(data_set6));
-
-    mp_hal_delay_ms(10);
-
-    write_cmd(CMD_INVCTR);
-
-    uint8_t data_set1[]={0x07};
-    write_data(data_set1, sizeof(data_set1));
-
-    
-    write_cmd(CMD_PWCTR1);
-
-    uint8_t dataset[]={0xA2, 0x02, 0x84};
-    write_data(dataset, sizeof(dataset));
-
-    write_cmd(CMD_PWCTR2);
-
-    uint8_t dataset1[]={0xC5};
-    write_data(dataset1, sizeof(dataset1));
-
-    write_cmd(CMD_PWCTR3);
-
-    uint8_t dataset2[]={0x8A, 0x00};
-    write_data(dataset2, sizeof(dataset2));
-
-    write_cmd(CMD_PWCTR4);
-
-    uint8_t dataset3[]={0x8A, 0x2A};
-    write_data(dataset3, sizeof(dataset3));
-
-    write_cmd(CMD_PWCTR5);
-
-    uint8_t dataset4[]={0x8A, 0xEE};
-    write_data(dataset4, sizeof(dataset4));
-
-    write_cmd(CMD_VMCTR1);
+    if(y<0)
+    {
+        h+=y;
+        y=0;
+    }
+    if(w<=0 || h<=0 || x>=self->width || y>=self->height)
+    {
+        return;
+    }
+    if(x+w>self->width)
+    {
+        w=self->width-x;
+    }
+    if(y+h>self->height)
+    {
+        h=self->height-y;
+    }
+    rect_int(self, x, y, w, h, color);
+}
 
-    uint8_t data_vmc[]={0x0E};
-    write_data(data_vmc, sizeof(data_vmc));
+/*
+    hspan() and vspan() | Intern Functions. Draw a horizontal span between the columns a and b (in any order)
+    or a vertical span between the rows a and b, each one with a single window.
+*/
+STATIC void hspan(tftdisp_class_obj_t *self, mp_int_t a, mp_int_t b, mp_int_t y, uint16_t color)
+{
+    if(a>b)
+    {
+        mp_int_t t=a;
+        a=b;
+        b=t;
+    }
+    fill_rect(self, a, y, b-a+1, 1, color);
+}
 
-    write_cmd(CMD_INVOFF);
+STATIC void vspan(tftdisp_class_obj_t *self, mp_int_t x, mp_int_t a, mp_int_t b, uint16_t color)
+{
+    if(a>b)
+    {
+        mp_int_t t=a;
+        a=b;
+        b=t;
+    }
+    fill_rect(self, x, a, 1, b-a+1, color);
+}
 
-    write_cmd(CMD_MADCTL);
+/*
+    ST7735() is the function that initializes the TFT screen is the equivalent of:
+        ST7735().init()
+    In this case there will be a change in which the function will be invoked as follows:
+        ST7735().init(True) or ST7735().init(1)
+    The argument is the rotation 0 to 3: 0 landscape, 1 portrait, 2 and 3 the same turned 180 degrees.
+    Without it the rotation given to the constructor is used.
+    The sequence takes about 250 ms, mostly waiting. With wait=False init() only starts it and returns, ready()
+    runs the next steps when their delay has expired and the first drawing call finishes it.
+    Example in uPython:
+        tft.init(0, False)
+        imu.init()
+        while not tft.ready():
+            pass
 
-    if(orient==0)
+*/
+STATIC mp_obj_t st7735_init(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    uint8_t orient=self->rotation;
+    if(n_args>1)
+    {
+        orient=mp_obj_get_int(args[1]);
+    }
+    if(orient>3)
     {
-        uint8_t data_orient[]={0xA0};
-        write_data(data_orient, sizeof(data_orient));
+        mp_raise_ValueError(MP_ERROR_TEXT("rotation must be 0 to 3"));
+    }
+    bool wait=(n_args<3) || mp_obj_is_true(args[2]);
 
-        self->width=160;
-        self->height=128;
+    self->console_on=false;
+    if(self->cells!=NULL)
+    {
+        //The grid of cells() depends on the orientation
+        m_del(tftdisp_cell_t, self->cells, self->cell_cols*self->cell_rows);
+        self->cells=NULL;
+    }
+    band_free(self);
+    self->idle_on=false;
+    self->partial_on=false;
+    //Rotations 1 and 3 are portrait, the panel size and offsets are exchanged
+    self->madctl=rotation_madctl[orient] | (self->bgr ? MADCTL_BGR : 0);
+    if(orient&0x01)
+    {
+        self->width=self->panel_height;
+        self->height=self->panel_width;
+        self->margin_col=self->row_offset;
+        self->margin_row=self->col_offset;
     }
     else
     {
-        uint8_t datas[]={0x00};
-        write_data(datas, sizeof(datas));
-
-        self->width=128;
-        self->height=160;
-
+        self->width=self->panel_width;
+        self->height=self->panel_height;
+        self->margin_col=self->col_offset;
+        self->margin_row=self->row_offset;
     }
-    write_cmd(CMD_COLMOD);
-
-    uint8_t dataset0[]={0x05};
-    write_data(dataset0, sizeof(dataset0));
-
-
-    write_cmd(CMD_CASET);
 
-    uint8_t dataset5[]={0x00, 0x01, 0x00, 127};
-    write_data(dataset5, sizeof(dataset5));
-
-
-    write_cmd(CMD_RASET);
-
-    uint8_t dataset6[]={0x00, 0x01, 0x00, 159};
-    write_data(dataset6, sizeof(dataset6));
-
-    
-    write_cmd(CMD_GMCTRP1);
-
-    uint8_t dataset7[]={0x02, 0x1c, 0x07, 0x12, 0x37, 0x32, 0x29, 0x2d, 0x29, 0x25, 0x2b, 0x39, 0x00, 0x01, 0x03, 0x10};
-    write_data(dataset7, sizeof(dataset7));
-
-
-    write_cmd(CMD_GMCTRN1);
-
-    uint8_t dataset8[]={0x03, 0x1d, 0x07, 0x06, 0x2e, 0x2c, 0x29, 0x2d, 0x2e, 0x2e, 0x37, 0x3f, 0x00, 0x00, 0x02, 0x10};
-    write_data(dataset8, sizeof(dataset8));
-
-
-    write_cmd(CMD_NORON);
-
-    mp_hal_delay_ms(10);
+    //The sequence starts with the hardware reset, see init_seq
+    dma_wait();
+    self->init_pos=0;
+    self->init_time=mp_hal_ticks_ms();
+    self->init_busy=true;
+    init_run(self, wait);
+    return mp_const_none;
+}
 
-    write_cmd(CMD_DISPON);
+/*
+    ready() | Runs the steps of an init(rotation, False) in progress whose delay has expired, without blocking.
+    Returns True when the display is initialized. Call it from the main loop or from a function scheduled
+    with micropython.schedule(), not from a hard interrupt.
+*/
+STATIC mp_obj_t ready(mp_obj_t self_in)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_bool(init_run(self, false));
+}
 
-    mp_hal_delay_ms(100);
-    
+/*
+    prescaler() | Returns the SPI clock divider of the display or changes it, a power of 2 from 2 to 256.
+    The clock of the display is the clock of the SPI bus divided by the prescaler (84 MHz for SPI1 on the Ophyra).
+    Example in uPython:
+        tft.prescaler(2)
+*/
+STATIC mp_obj_t prescaler(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if(n_args==1)
+    {
+        return mp_obj_new_int(self->prescaler);
+    }
+    mp_int_t value=mp_obj_get_int(args[1]);
+    if(value<2 || value>256 || (value&(value-1))!=0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("prescaler must be a power of 2 from 2 to 256"));
+    }
+    dma_wait();
+    self->prescaler=value;
+    spi_prescaler(value);
     return mp_const_none;
 }
 
+/*
+    benchmark() | Fills the whole display once with every prescaler from 2 to 256 and returns a list of tuples
+    (prescaler, microseconds, kilobytes per second). Every fill has a different color, a panel that does not
+    tolerate a clock shows a wrong color or garbage. The prescaler of the display is restored at the end.
+    Example in uPython:
+        for p, us, kbs in tft.benchmark():
+            print(p, us, kbs)
+*/
+STATIC mp_obj_t benchmark(mp_obj_t self_in)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    static const uint16_t colors[]={0xF800, 0x07E0, 0x001F, 0xFFE0, 0x07FF, 0xF81F, 0xFFFF, 0x0000};
+    uint32_t pixels=self->width*self->height;
+    mp_obj_t list=mp_obj_new_list(0, NULL);
+    dma_wait();
+    for(uint16_t p=2, i=0; p<=256; p<<=1, i++)
+    {
+        spi_prescaler(p);
+        //Straight to the display even with the framebuffer enabled
+        mp_uint_t start=mp_hal_ticks_us();
+        set_window(self, 0, 0, self->width-1, self->height-1);
+        write_pixels(pixels, colors[i]);
+        mp_uint_t us=mp_hal_ticks_us()-start;
+        mp_obj_t item[3]={
+            mp_obj_new_int(p),
+            mp_obj_new_int_from_uint(us),
+            mp_obj_new_int_from_uint(us ? (uint64_t)pixels*2*1000/us : 0),
+        };
+        mp_obj_list_append(list, mp_obj_new_tuple(3, item));
+    }
+    spi_prescaler(self->prescaler);
+    return list;
+}
+
 /*
     power() this function is used to turn on the screen or to obtain the screen status.
+    power(False) also puts the controller in sleep mode (the display RAM is kept) and turns the backlight off,
+    which is the state with the lowest consumption. power(True) wakes it up and restores the backlight() setting.
 */
 STATIC mp_obj_t power(mp_obj_t self_in, mp_obj_t state)
 {
@@ -625,20 +1340,101 @@ STATIC mp_obj_t power(mp_obj_t self_in, mp_obj_t state)
     {
         return mp_obj_new_bool(self->power_on?1:0);
     }
-    if(state==mp_const_true)
+    init_finish(self);
+    if(state==mp_const_true && !self->power_on)
     {
+        write_cmd(CMD_SLPOUT);
+        mp_hal_delay_ms(120);
         write_cmd(CMD_DISPON);
+        if(self->backlight_on)
+        {
+            mp_hal_pin_high(Pin_BL);
+        }
         self->power_on=true;
     }
-    if (state==mp_const_false)
+    if (state==mp_const_false && self->power_on)
     {
+        mp_hal_pin_low(Pin_BL);
         write_cmd(CMD_DISPOFF);
+        write_cmd(CMD_SLPIN);
         self->power_on=false;
     }
     return mp_const_none;
     
 }
 
+/*
+    Rows of the panel RAM addressed by the partial mode and the hardware scrolling.
+*/
+#define PANEL_RAM_ROWS  (162)
+
+/*
+    partial() | Shows only the RAM rows start to end (inclusive) of the panel, the rest of the display is left blank,
+    which reduces the consumption of the panel. partial(None) returns to the normal (full screen) mode and
+    partial() returns the current area as a tuple, or None.
+    The rows are along the 160 pixel side of the panel, the vertical axis with init(1).
+    Example in uPython:
+        tft.partial(0, 15)
+        tft.idle(True)
+*/
+STATIC mp_obj_t partial(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if(n_args==1)
+    {
+        if(!self->partial_on)
+        {
+            return mp_const_none;
+        }
+        mp_obj_t area[2]={mp_obj_new_int(self->partial_start), mp_obj_new_int(self->partial_end)};
+        return mp_obj_new_tuple(2, area);
+    }
+    init_finish(self);
+    if(args[1]==mp_const_none)
+    {
+        write_cmd(CMD_NORON);
+        self->partial_on=false;
+        return mp_const_none;
+    }
+    if(n_args<3)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("start and end rows needed"));
+    }
+    mp_int_t start=mp_obj_get_int(args[1]);
+    mp_int_t end=mp_obj_get_int(args[2]);
+    if(start<0 || start>=PANEL_RAM_ROWS || end<0 || end>=PANEL_RAM_ROWS)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid partial rows"));
+    }
+    write_cmd(CMD_PTLAR);
+    uint8_t offset=ram_row_offset(self);
+    uint8_t data[]={0x00, start + offset, 0x00, end + offset};
+    write_data(data, sizeof(data));
+    write_cmd(CMD_PTLON);
+    self->partial_start=start;
+    self->partial_end=end;
+    self->partial_on=true;
+    return mp_const_none;
+}
+
+/*
+    idle() | Turns the idle mode on or off, or returns its state when called without arguments.
+    In idle mode the panel only shows 8 colors (the most significant bit of red, green and blue) with the
+    frame rate set by CMD_FRMCTR2, which lowers the consumption of the display.
+*/
+STATIC mp_obj_t idle(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if(n_args==1)
+    {
+        return mp_obj_new_bool(self->idle_on);
+    }
+    init_finish(self);
+    self->idle_on=mp_obj_is_true(args[1]);
+    write_cmd(self->idle_on ? CMD_IDMON : CMD_IDMOFF);
+    return mp_const_none;
+}
+
 /*
     inverted() is used to obtain a color inversion on the TFT by means of commands
 */
@@ -650,6 +1446,7 @@ STATIC mp_obj_t inverted(mp_obj_t self_in, mp_obj_t state)
     {
         return mp_obj_new_bool(self->inverted?1:0);
     }
+    init_finish(self);
     if(state==mp_const_true || state==mp_obj_new_int(1))
     {
         write_cmd(CMD_INVON);
@@ -666,6 +1463,7 @@ STATIC mp_obj_t inverted(mp_obj_t self_in, mp_obj_t state)
 
 /*
     backlight() This function allows you to turn on the light of the TFT screen.
+    While the display is off with power(False) the setting is only stored and applied by power(True).
 */
 STATIC mp_obj_t backlight(mp_obj_t self_in, mp_obj_t state)
 {
@@ -676,7 +1474,10 @@ STATIC mp_obj_t backlight(mp_obj_t self_in, mp_obj_t state)
     }
     if(state==mp_obj_new_int(1) || state==mp_const_true)
     {
-        mp_hal_pin_high(Pin_BL);
+        if(self->power_on)
+        {
+            mp_hal_pin_high(Pin_BL);
+        }
         self->backlight_on=true;
     }
     else
@@ -715,6 +1516,163 @@ STATIC mp_obj_t rgbcolor(size_t n_args, const mp_obj_t *args)
     return mp_obj_new_int(((red & 0xF8) << 8) | ((green & 0xFC) << 3 ) | (blue >> 3));
 }
 
+/*
+    Source formats of convert().
+*/
+#define CONV_RGB888     (0)     // 3 bytes per pixel, red first
+#define CONV_GRAY8      (1)     // 1 byte per pixel, or index of a 256 color palette
+#define CONV_MONO       (2)     // 1 bit per pixel, most significant bit first
+
+/*
+    REV16() | Exchanges the bytes of both halves of a word: two RGB565 pixels packed by the little-endian MCU
+    become the panel byte order with a single instruction on the Cortex-M4.
+*/
+#if !TFTDISP_EMULATOR
+#define REV16(v)    __REV16(v)
+#else
+#define REV16(v)    ((((v)>>8)&0x00FF00FF) | (((v)<<8)&0xFF00FF00))
+#endif
+#define RGB565(r, g, b) ((((r)&0xF8)<<8) | (((g)&0xFC)<<3) | (((b)&0xFF)>>3))
+
+/*
+    conv_rgb888() | Intern Function. Converts n RGB888 pixels to RGB565 in panel byte order. Four pixels are read
+    as three words and written as two, memcpy() compiles to single unaligned loads and stores on the Cortex-M4.
+*/
+STATIC void conv_rgb888(uint8_t *dst, const uint8_t *src, size_t n)
+{
+    for(; n>=4; n-=4, src+=12, dst+=8)
+    {
+        uint32_t w[3];
+        memcpy(w, src, 12);
+        uint32_t p0=RGB565(w[0], w[0]>>8, w[0]>>16);
+        uint32_t p1=RGB565(w[0]>>24, w[1], w[1]>>8);
+        uint32_t p2=RGB565(w[1]>>16, w[1]>>24, w[2]);
+        uint32_t p3=RGB565(w[2]>>8, w[2]>>16, w[2]>>24);
+        uint32_t out[2]={REV16(p0 | (p1<<16)), REV16(p2 | (p3<<16))};
+        memcpy(dst, out, 8);
+    }
+    for(; n>0; n--, src+=3, dst+=2)
+    {
+        uint16_t c=RGB565(src[0], src[1], src[2]);
+        dst[0]=(uint8_t)(c>>8);
+        dst[1]=(uint8_t)(c&0xFF);
+    }
+}
+
+/*
+    conv_gray8() | Intern Function. Converts n 8 bit pixels to RGB565 in panel byte order, through palette
+    (256 RGB565 colors) when it is not NULL. Four pixels are read as one word and written as two.
+*/
+STATIC void conv_gray8(uint8_t *dst, const uint8_t *src, size_t n, const uint16_t *palette)
+{
+    for(; n>=4; n-=4, src+=4, dst+=8)
+    {
+        uint32_t v;
+        memcpy(&v, src, 4);
+        uint32_t p[4];
+        for(uint8_t i=0; i<4; i++, v>>=8)
+        {
+            uint8_t g=v&0xFF;
+            p[i]=(palette!=NULL) ? palette[g] : RGB565(g, g, g);
+        }
+        uint32_t out[2]={REV16(p[0] | (p[1]<<16)), REV16(p[2] | (p[3]<<16))};
+        memcpy(dst, out, 8);
+    }
+    for(; n>0; n--, src++, dst+=2)
+    {
+        uint16_t c=(palette!=NULL) ? palette[*src] : RGB565(*src, *src, *src);
+        dst[0]=(uint8_t)(c>>8);
+        dst[1]=(uint8_t)(c&0xFF);
+    }
+}
+
+/*
+    conv_mono() | Intern Function. Converts the n bytes of a 1 bit image to 8*n pixels of color (bits set) or
+    color_bcknd, two pixels per word written.
+*/
+STATIC void conv_mono(uint8_t *dst, const uint8_t *src, size_t n, uint16_t color, uint16_t color_bcknd)
+{
+    //Words for every pair of bits, already in panel byte order
+    uint32_t pairs[4];
+    for(uint8_t i=0; i<4; i++)
+    {
+        uint32_t first=(i&0x02) ? color : color_bcknd;
+        uint32_t second=(i&0x01) ? color : color_bcknd;
+        pairs[i]=REV16(first | (second<<16));
+    }
+    for(; n>0; n--, src++, dst+=16)
+    {
+        uint32_t out[4]={pairs[*src>>6], pairs[(*src>>4)&0x03], pairs[(*src>>2)&0x03], pairs[*src&0x03]};
+        memcpy(dst, out, 16);
+    }
+}
+
+/*
+    convert() | Converts a whole buffer of pixels to RGB565 in panel byte order into dst, ready for blit().
+    Returns the number of pixels converted.
+        -> RGB888 3 bytes per pixel (red, green, blue).
+        -> GRAY8 1 byte per pixel, gray levels or, with a palette (array('H') of 256 RGB565 colors), indexes
+           of the palette, for example for a heatmap.
+        -> MONO 1 bit per pixel, most significant bit first, drawn with color and color_bcknd (white and black by default).
+    Example in uPython:
+        rgb=camera.read()
+        out=bytearray(len(rgb)//3*2)
+        tft.convert(out, rgb, tft.RGB888)
+        tft.blit(0, 0, 80, 60, out)
+*/
+STATIC mp_obj_t convert(size_t n_args, const mp_obj_t *args)
+{
+    mp_buffer_info_t dst, src;
+    mp_get_buffer_raise(args[1], &dst, MP_BUFFER_WRITE);
+    mp_get_buffer_raise(args[2], &src, MP_BUFFER_READ);
+    mp_int_t format=mp_obj_get_int(args[3]);
+    size_t n;
+    switch(format)
+    {
+        case CONV_RGB888:
+            n=src.len/3;
+            break;
+        case CONV_GRAY8:
+            n=src.len;
+            break;
+        case CONV_MONO:
+            n=src.len*8;
+            break;
+        default:
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid format"));
+    }
+    if(dst.len<n*2)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
+    if(format==CONV_RGB888)
+    {
+        conv_rgb888(dst.buf, src.buf, n);
+    }
+    else if(format==CONV_GRAY8)
+    {
+        const uint16_t *palette=NULL;
+        if(n_args>4)
+        {
+            mp_buffer_info_t pal;
+            mp_get_buffer_raise(args[4], &pal, MP_BUFFER_READ);
+            if(pal.len<256*2)
+            {
+                mp_raise_ValueError(MP_ERROR_TEXT("palette needs 256 colors"));
+            }
+            palette=pal.buf;
+        }
+        conv_gray8(dst.buf, src.buf, n, palette);
+    }
+    else
+    {
+        uint16_t color=(n_args>4) ? mp_obj_get_int(args[4]) : COLOR_WHITE;
+        uint16_t color_bcknd=(n_args>5) ? mp_obj_get_int(args[5]) : COLOR_BLACK;
+        conv_mono(dst.buf, src.buf, src.len, color, color_bcknd);
+    }
+    return mp_obj_new_int(n);
+}
+
 /*
     rect() This function is used for the creation of a
     quadrilatero in which through the coordinates x, y
@@ -738,364 +1696,2261 @@ STATIC mp_obj_t rect(size_t n_args, const mp_obj_t *args)
 }
 
 /*
-    line() This function creates the line drawing on the display through Bresenham's algorithm
+    line_int() | Intern Function. Bresenham's algorithm emitting spans: the pixels of a mostly horizontal line that
+    share a row are drawn as one horizontal span, and those of a mostly vertical line that share a column as one vertical span.
 */
-STATIC mp_obj_t line(size_t n_args, const mp_obj_t *args)
+STATIC void line_int(tftdisp_class_obj_t *self, mp_int_t x0, mp_int_t y0, mp_int_t x1, mp_int_t y1, uint16_t color)
 {
-    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
-    //transformar los objetos
-    uint8_t x0=mp_obj_get_int(args[1]);
-    uint8_t y0=mp_obj_get_int(args[2]);
-    uint8_t x1=mp_obj_get_int(args[3]);
-    uint8_t y1=mp_obj_get_int(args[4]);
-    uint16_t color=mp_obj_get_int(args[5]);
-    uint8_t start, end;
-    //comienzo de la funcion
-    if(x0==x1)
+    mp_int_t dx=(x1>x0) ? x1-x0 : x0-x1;
+    mp_int_t dy=(y1>y0) ? y1-y0 : y0-y1;
+    mp_int_t inx=(x0<x1) ? 1 : -1;
+    mp_int_t iny=(y0<y1) ? 1 : -1;
+    if(dx>=dy)
     {
-        if (y1<y0)
-        {
-            start=x1;
-            end=y1;
-        }
-        else
+        mp_int_t err=dx/2;
+        mp_int_t start=x0;
+        while(x0!=x1)
         {
-            start=x0;
-            end=y0;
+            err-=dy;
+            if(err<0)
+            {
+                hspan(self, start, x0, y0, color);
+                y0+=iny;
+                err+=dx;
+                start=x0+inx;
+            }
+            x0+=inx;
         }
-        vline(self, start, end, abs(y1-y0)+1, color);
+        hspan(self, start, x1, y0, color);
     }
-    else if(y0==y1)
+    else
     {
-        if (x1<x0)
-        {
-            start=x1;
-            end=y1;
-        }
-        else
+        mp_int_t err=dy/2;
+        mp_int_t start=y0;
+        while(y0!=y1)
         {
-            start=x0;
-            end=y0;
-        }
-        hline(self, start, end, abs(x1-x0)+1, color);
-    }
-    else
-    {   
-        //Start Bresenham's algorithm
-        int dx = abs(x1-x0), inx = x0<x1 ? 1 : -1;
-        int dy = abs(y1-y0), iny = y0<y1 ? 1 : -1; 
-        int err = (dx>dy ? dx : -dy)/2, e2;
- 
-        while(1){
-            pixel0(self, x0, y0, color);
-            if (x0==x1 && y0==y1) break;
-            e2 = err;
-            if(e2 >-dx) 
-            { 
-                err -= dy; 
-                x0 += inx; 
-            }
-            if(e2 < dy) 
-            { 
-                err += dx;
-                y0 += iny; }
+            err-=dx;
+            if(err<0)
+            {
+                vspan(self, x0, start, y0, color);
+                x0+=inx;
+                err+=dy;
+                start=y0+iny;
             }
+            y0+=iny;
+        }
+        vspan(self, x0, start, y1, color);
     }
-    return mp_const_none;
-    
 }
 
 /*
-    char() | Intern Function. This function puts a single character on the screen.
-    tft, this function is a dependency of the text() function.
-    
-    CHANGELOG
-        Add a flag and add an extra color for the text background if required.
-        bool flag and uint16_t color_bcknd
+    line() This function creates the line drawing on the display through Bresenham's algorithm
 */
-STATIC mp_obj_t charfunc(mp_obj_t self_in, uint8_t x, uint8_t y, char ch, uint16_t color, uint8_t sizex, uint8_t sizey, bool flag, uint16_t color_bcknd)
+STATIC mp_obj_t line(size_t n_args, const mp_obj_t *args)
 {
-    //Draw a character at a given position using the user font.
-    //Font is a data dictionary, can be scaled with sizex and sizey.
-    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    //Font is define not necesary put parameter in this function
-    uint16_t ci=(uint16_t)ch;
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    line_int(self, mp_obj_get_int(args[1]), mp_obj_get_int(args[2]), mp_obj_get_int(args[3]), mp_obj_get_int(args[4]), mp_obj_get_int(args[5]));
+    return mp_const_none;
+}
 
-    if(!sizex && !sizey)
+/*
+    circle_width() | Intern Function. Returns the half width of the row k of a circle of radius r,
+    starting the search from the half width x of the previous row.
+*/
+STATIC mp_int_t circle_width(mp_int_t r, mp_int_t k, mp_int_t x)
+{
+    while(x>0 && x*x+k*k>r*r+r)
     {
-        //this is by defect in the function uPython
-        sizex=1;
-        sizey=1;
+        x--;
     }
+    return x;
+}
 
-    if(START<=ci && ci<=END)
+/*
+    circle_int() | Intern Function. Draws the outline of a circle of radius r centered at (cx, cy). The right half is moved dx
+    pixels and the bottom half dy pixels, this gives the corners of a rounded rectangle. The octants near the top and bottom
+    are drawn with horizontal spans and mirrored on the diagonal as vertical spans for the sides.
+*/
+STATIC void circle_int(tftdisp_class_obj_t *self, mp_int_t cx, mp_int_t cy, mp_int_t r, mp_int_t dx, mp_int_t dy, uint16_t color)
+{
+    if(r<=0)
     {
-        ci=(ci-START)*WIDTH;
-
-        // this the equivalent to ch = font['data'][ci:ci + width]
-        uint8_t ch[6];
-        for(uint8_t i=0;i<WIDTH;i++)
+        fill_rect(self, cx, cy, dx+1, dy+1, color);
+        return;
+    }
+    //Half widths of the rows k and k+1
+    mp_int_t hw=r;
+    mp_int_t next=circle_width(r, 1, r);
+    for(mp_int_t k=0; k<=r; k++)
+    {
+        mp_int_t lo=(next+1<hw) ? next+1 : hw;
+        mp_int_t hi=(hw<k) ? hw : k;
+        if(lo<=hi)
         {
-            ch[i]=Font[ci];
-            ci++;
+            hspan(self, cx+dx+lo, cx+dx+hi, cy-k, color);
+            hspan(self, cx-hi, cx-lo, cy-k, color);
+            hspan(self, cx+dx+lo, cx+dx+hi, cy+dy+k, color);
+            hspan(self, cx-hi, cx-lo, cy+dy+k, color);
+            vspan(self, cx+dx+k, cy-hi, cy-lo, color);
+            vspan(self, cx-k, cy-hi, cy-lo, color);
+            vspan(self, cx+dx+k, cy+dy+lo, cy+dy+hi, color);
+            vspan(self, cx-k, cy+dy+lo, cy+dy+hi, color);
         }
-        //end to equivalent
-        
-        //no font scaling
-        uint8_t px=x;
+        hw=next;
+        next=(k+2<=r) ? circle_width(r, k+2, next) : -1;
+    }
+}
 
-        if(sizex<=1 && sizey<=1)
-        {
-            for(uint8_t k=0; k<WIDTH;k++)
-            {
-                uint8_t py=y;
+/*
+    fill_circle_int() | Intern Function. Fills the top and bottom caps of a circle of radius r, one horizontal span per row.
+    The rows cy to cy+dy are not drawn, as in circle_int() the right half is moved dx pixels and the bottom one dy pixels.
+*/
+STATIC void fill_circle_int(tftdisp_class_obj_t *self, mp_int_t cx, mp_int_t cy, mp_int_t r, mp_int_t dx, mp_int_t dy, uint16_t color)
+{
+    mp_int_t x=r;
+    for(mp_int_t k=1; k<=r; k++)
+    {
+        x=circle_width(r, k, x);
+        fill_rect(self, cx-x, cy-k, 2*x+1+dx, 1, color);
+        fill_rect(self, cx-x, cy+dy+k, 2*x+1+dx, 1, color);
+    }
+}
 
-                char temp = ch[k];
-                for(uint8_t i=0; i<HEIGHT;i++)
-                {
-                    if(temp&0x01)
-                    {
-                        pixel0(self, px, py, color);
-                    }
-                    else if(flag)
-                    {
-                        pixel0(self, px, py, color_bcknd);
+/*
+    fill_triangle_int() | Intern Function. Fills a triangle row by row with horizontal spans.
+*/
+STATIC void fill_triangle_int(tftdisp_class_obj_t *self, mp_int_t x0, mp_int_t y0, mp_int_t x1, mp_int_t y1, mp_int_t x2, mp_int_t y2, uint16_t color)
+{
+    mp_int_t t;
+    //Sort the vertices by y
+    if(y0>y1)
+    {
+        t=y0; y0=y1; y1=t;
+        t=x0; x0=x1; x1=t;
+    }
+    if(y1>y2)
+    {
+        t=y1; y1=y2; y2=t;
+        t=x1; x1=x2; x2=t;
+    }
+    if(y0>y1)
+    {
+        t=y0; y0=y1; y1=t;
+        t=x0; x0=x1; x1=t;
+    }
+    if(y0==y2)
+    {
+        mp_int_t a=x0, b=x0;
+        if(x1<a) a=x1;
+        if(x1>b) b=x1;
+        if(x2<a) a=x2;
+        if(x2>b) b=x2;
+        hspan(self, a, b, y0, color);
+        return;
+    }
+    for(mp_int_t y=y0; y<=y2; y++)
+    {
+        //Long edge 0-2 and the short edge 0-1 or 1-2
+        mp_int_t a=x0+(x2-x0)*(y-y0)/(y2-y0);
+        mp_int_t b;
+        if(y<y1)
+        {
+            b=x0+(x1-x0)*(y-y0)/(y1-y0);
+        }
+        else if(y2!=y1)
+        {
+            b=x1+(x2-x1)*(y-y1)/(y2-y1);
+        }
+        else
+        {
+            b=x1;
+        }
+        hspan(self, a, b, y, color);
+    }
+}
+
+/*
+    Maximum number of vertices of polygon() and fill_polygon().
+*/
+#define POLY_MAX    (64)
+
+/*
+    get_points() | Intern Function. Reads a list or tuple of (x, y) pairs, returns the number of vertices.
+*/
+STATIC size_t get_points(mp_obj_t points_in, mp_int_t *px, mp_int_t *py)
+{
+    size_t n;
+    mp_obj_t *points;
+    mp_obj_get_array(points_in, &n, &points);
+    if(n>POLY_MAX)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("too many points"));
+    }
+    for(size_t i=0; i<n; i++)
+    {
+        size_t len;
+        mp_obj_t *xy;
+        mp_obj_get_array(points[i], &len, &xy);
+        if(len!=2)
+        {
+            mp_raise_ValueError(MP_ERROR_TEXT("points must be (x, y) pairs"));
+        }
+        px[i]=mp_obj_get_int(xy[0]);
+        py[i]=mp_obj_get_int(xy[1]);
+    }
+    return n;
+}
+
+/*
+    circle() and fill_circle() | Draw the outline of a circle or a filled circle of radius r centered at (x, y).
+    Example in uPython:
+        tft.fill_circle(80,64,20,tft.rgbcolor(255,0,0))
+*/
+STATIC mp_obj_t circle(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    circle_int(self, mp_obj_get_int(args[1]), mp_obj_get_int(args[2]), mp_obj_get_int(args[3]), 0, 0, mp_obj_get_int(args[4]));
+    return mp_const_none;
+}
+
+STATIC mp_obj_t fill_circle(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t x=mp_obj_get_int(args[1]);
+    mp_int_t y=mp_obj_get_int(args[2]);
+    mp_int_t r=mp_obj_get_int(args[3]);
+    uint16_t color=mp_obj_get_int(args[4]);
+    if(r<0)
+    {
+        return mp_const_none;
+    }
+    fill_rect(self, x-r, y, 2*r+1, 1, color);
+    fill_circle_int(self, x, y, r, 0, 0, color);
+    return mp_const_none;
+}
+
+/*
+    triangle() and fill_triangle() | Draw the outline of a triangle or a filled triangle.
+    Example in uPython:
+        tft.fill_triangle(10,10,60,20,30,70,tft.rgbcolor(0,0,255))
+*/
+STATIC mp_obj_t triangle(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t x0=mp_obj_get_int(args[1]);
+    mp_int_t y0=mp_obj_get_int(args[2]);
+    mp_int_t x1=mp_obj_get_int(args[3]);
+    mp_int_t y1=mp_obj_get_int(args[4]);
+    mp_int_t x2=mp_obj_get_int(args[5]);
+    mp_int_t y2=mp_obj_get_int(args[6]);
+    uint16_t color=mp_obj_get_int(args[7]);
+    line_int(self, x0, y0, x1, y1, color);
+    line_int(self, x1, y1, x2, y2, color);
+    line_int(self, x2, y2, x0, y0, color);
+    return mp_const_none;
+}
+
+STATIC mp_obj_t fill_triangle(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    fill_triangle_int(self, mp_obj_get_int(args[1]), mp_obj_get_int(args[2]), mp_obj_get_int(args[3]), mp_obj_get_int(args[4]),
+        mp_obj_get_int(args[5]), mp_obj_get_int(args[6]), mp_obj_get_int(args[7]));
+    return mp_const_none;
+}
+
+/*
+    polygon() and fill_polygon() | Draw the outline of a closed polygon or fill it (even-odd rule),
+    points is a list or tuple of up to 64 (x, y) pairs.
+    Example in uPython:
+        tft.fill_polygon([(10,10),(50,15),(40,60),(5,40)],tft.rgbcolor(0,255,0))
+*/
+STATIC mp_obj_t polygon(mp_obj_t self_in, mp_obj_t points, mp_obj_t color_in)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_int_t px[POLY_MAX], py[POLY_MAX];
+    size_t n=get_points(points, px, py);
+    uint16_t color=mp_obj_get_int(color_in);
+    for(size_t i=0; i<n; i++)
+    {
+        size_t j=(i+1)%n;
+        line_int(self, px[i], py[i], px[j], py[j], color);
+    }
+    return mp_const_none;
+}
+
+STATIC mp_obj_t fill_polygon(mp_obj_t self_in, mp_obj_t points, mp_obj_t color_in)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_int_t px[POLY_MAX], py[POLY_MAX], nodes[POLY_MAX];
+    size_t n=get_points(points, px, py);
+    uint16_t color=mp_obj_get_int(color_in);
+    if(n<3)
+    {
+        return mp_const_none;
+    }
+    mp_int_t ymin=py[0], ymax=py[0];
+    for(size_t i=1; i<n; i++)
+    {
+        if(py[i]<ymin) ymin=py[i];
+        if(py[i]>ymax) ymax=py[i];
+    }
+    if(ymin<0)
+    {
+        ymin=0;
+    }
+    if(ymax>=self->height)
+    {
+        ymax=self->height-1;
+    }
+    for(mp_int_t y=ymin; y<=ymax; y++)
+    {
+        //Crossings of the row with the edges, sorted by x
+        size_t count=0;
+        for(size_t i=0; i<n; i++)
+        {
+            size_t j=(i+1)%n;
+            if((py[i]<=y && py[j]>y) || (py[j]<=y && py[i]>y))
+            {
+                mp_int_t x=px[i]+(y-py[i])*(px[j]-px[i])/(py[j]-py[i]);
+                size_t k=count++;
+                while(k>0 && nodes[k-1]>x)
+                {
+                    nodes[k]=nodes[k-1];
+                    k--;
+                }
+                nodes[k]=x;
+            }
+        }
+        for(size_t k=0; k+1<count; k+=2)
+        {
+            hspan(self, nodes[k], nodes[k+1], y, color);
+        }
+    }
+    return mp_const_none;
+}
+
+/*
+    round_rect() and fill_round_rect() | Draw the outline of a rectangle with rounded corners of radius r, or fill it.
+    Example in uPython:
+        tft.fill_round_rect(10,10,80,30,6,tft.rgbcolor(255,255,0))
+*/
+STATIC mp_obj_t round_rect(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t x=mp_obj_get_int(args[1]);
+    mp_int_t y=mp_obj_get_int(args[2]);
+    mp_int_t w=mp_obj_get_int(args[3]);
+    mp_int_t h=mp_obj_get_int(args[4]);
+    mp_int_t r=mp_obj_get_int(args[5]);
+    uint16_t color=mp_obj_get_int(args[6]);
+    if(w<=0 || h<=0)
+    {
+        return mp_const_none;
+    }
+    if(r<0) r=0;
+    if(2*r>w) r=w/2;
+    if(2*r>h) r=h/2;
+    fill_rect(self, x+r, y, w-2*r, 1, color);
+    fill_rect(self, x+r, y+h-1, w-2*r, 1, color);
+    fill_rect(self, x, y+r, 1, h-2*r, color);
+    fill_rect(self, x+w-1, y+r, 1, h-2*r, color);
+    if(r==0)
+    {
+        //circle_int() fills the whole area with a radius of 0
+        return mp_const_none;
+    }
+    circle_int(self, x+r, y+r, r, w-2*r-1, h-2*r-1, color);
+    return mp_const_none;
+}
+
+STATIC mp_obj_t fill_round_rect(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t x=mp_obj_get_int(args[1]);
+    mp_int_t y=mp_obj_get_int(args[2]);
+    mp_int_t w=mp_obj_get_int(args[3]);
+    mp_int_t h=mp_obj_get_int(args[4]);
+    mp_int_t r=mp_obj_get_int(args[5]);
+    uint16_t color=mp_obj_get_int(args[6]);
+    if(w<=0 || h<=0)
+    {
+        return mp_const_none;
+    }
+    if(r<0) r=0;
+    if(2*r>w) r=w/2;
+    if(2*r>h) r=h/2;
+    fill_rect(self, x, y+r, w, h-2*r, color);
+    fill_circle_int(self, x+r, y+r, r, w-2*r-1, h-2*r-1, color);
+    return mp_const_none;
+}
+
+/*
+    Line buffer used by text_row() to send one pixel row of a whole string at a time.
+*/
+#define LINE_BUF_PIXELS (256)
+STATIC uint8_t line_buf[LINE_BUF_PIXELS*2];
+
+STATIC void blit_int(tftdisp_class_obj_t *self, mp_int_t x, mp_int_t y, mp_int_t w, mp_int_t h, const uint8_t *data, bool swap, bool block);
+
+/*
+    font_glyph() | Intern Function. Returns the columns of the character ch in the font and its width in w.
+    Returns NULL if the font does not have the character, it is drawn as an empty cell of the font width.
+*/
+STATIC const uint8_t *font_glyph(const tftdisp_font_t *font, char ch, uint8_t *w)
+{
+    uint8_t ci=(uint8_t)ch;
+    *w=font->width;
+    if(ci<font->first || ci>font->last)
+    {
+        return NULL;
+    }
+    ci-=font->first;
+    if(font->widths==NULL)
+    {
+        return &font->data[ci*font->width*FONT_COL_BYTES(font)];
+    }
+    if(font->widths[ci]==0)
+    {
+        return NULL;
+    }
+    *w=font->widths[ci];
+    return &font->data[font->offset[ci]];
+}
+
+/*
+    glyph_level() | Intern Function. Coverage of the pixel (k, r) of a glyph, 0 to 1 or 0 to 3 in the anti-aliased fonts.
+*/
+STATIC uint8_t glyph_level(const tftdisp_font_t *font, const uint8_t *glyph, uint8_t k, uint8_t r)
+{
+    uint16_t bit=r*font->bpp;
+    uint8_t b=glyph[k*FONT_COL_BYTES(font) + (bit>>3)];
+    return (b>>(bit&0x07)) & ((1<<font->bpp)-1);
+}
+
+/*
+    char_advance() | Intern Function. Pixels that the character moves the text cursor, the glyph and the spacing of the font.
+*/
+STATIC uint16_t char_advance(const tftdisp_font_t *font, char ch, uint8_t size)
+{
+    uint8_t w;
+    font_glyph(font, ch, &w);
+    return (w+font->spacing)*size;
+}
+
+/*
+    glyph_palette() | Intern Function. Color of every coverage level of the font, from the background to the text color.
+    The intermediate levels of the anti-aliased fonts are mixed channel by channel.
+*/
+STATIC void glyph_palette(const tftdisp_font_t *font, uint16_t color, uint16_t color_bcknd, uint16_t *palette)
+{
+    uint8_t levels=(1<<font->bpp)-1;
+    for(uint8_t l=0; l<=levels; l++)
+    {
+        uint16_t r=(((color>>11)&0x1F)*l + ((color_bcknd>>11)&0x1F)*(levels-l) + levels/2)/levels;
+        uint16_t g=(((color>>5)&0x3F)*l + ((color_bcknd>>5)&0x3F)*(levels-l) + levels/2)/levels;
+        uint16_t b=((color&0x1F)*l + (color_bcknd&0x1F)*(levels-l) + levels/2)/levels;
+        palette[l]=(r<<11) | (g<<5) | b;
+    }
+}
+
+/*
+    glyph_row() | Intern Function. Renders the pixel row r of a glyph of w columns into buf, every column repeated
+    sizex times, followed by gap columns of background. RGB565 with the high byte first.
+    A NULL glyph is rendered with the background color.
+*/
+STATIC void glyph_row(uint8_t *buf, const tftdisp_font_t *font, const uint8_t *glyph, uint8_t w, uint8_t gap, uint8_t r, uint8_t sizex, const uint16_t *palette)
+{
+    for(uint8_t k=0; k<w+gap; k++)
+    {
+        uint16_t c=palette[(glyph!=NULL && k<w) ? glyph_level(font, glyph, k, r) : 0];
+        for(uint8_t s=0; s<sizex; s++)
+        {
+            *buf++=(uint8_t)(c>>8);
+            *buf++=(uint8_t)(c&0xFF);
+        }
+    }
+}
+
+/*
+    glyph_cache_flush() | Intern Function. Empties the glyph cache, waiting first for a transfer that may be reading it.
+*/
+STATIC void glyph_cache_flush(tftdisp_class_obj_t *self)
+{
+    dma_wait();
+    self->gcache_used=0;
+    self->gcache_count=0;
+}
+
+/*
+    glyph_cache_get() | Intern Function. Returns the pixels of a character already scaled and rendered with its colors,
+    rendering it into the cache the first time. Returns NULL if the character does not fit in the cache.
+    The cache only keeps one pair of colors, drawing with other colors empties it. When it is full it is emptied
+    instead of tracking the use of every glyph, the text of a display uses a small set of characters.
+*/
+STATIC const uint8_t *glyph_cache_get(tftdisp_class_obj_t *self, const tftdisp_font_t *font, char ch, uint8_t gap, uint8_t sizex, uint8_t sizey, uint16_t color, uint16_t color_bcknd)
+{
+    if(color!=self->gcache_color || color_bcknd!=self->gcache_bcknd)
+    {
+        glyph_cache_flush(self);
+        self->gcache_color=color;
+        self->gcache_bcknd=color_bcknd;
+    }
+    for(uint8_t i=0; i<self->gcache_count; i++)
+    {
+        glyph_cache_entry_t *e=&self->gcache_entry[i];
+        if(e->font==font && e->ch==ch && e->gap==gap && e->sizex==sizex && e->sizey==sizey)
+        {
+            return &self->gcache[e->offset];
+        }
+    }
+
+    uint8_t w;
+    const uint8_t *glyph=font_glyph(font, ch, &w);
+    uint32_t row_len=(w+gap)*sizex*2;
+    uint32_t len=row_len*font->height*sizey;
+    if(len>self->gcache_size)
+    {
+        return NULL;
+    }
+    if(self->gcache_count==GLYPH_CACHE_SLOTS || self->gcache_used+len>self->gcache_size)
+    {
+        glyph_cache_flush(self);
+    }
+    glyph_cache_entry_t *e=&self->gcache_entry[self->gcache_count++];
+    e->font=font;
+    e->ch=ch;
+    e->gap=gap;
+    e->sizex=sizex;
+    e->sizey=sizey;
+    e->offset=self->gcache_used;
+    self->gcache_used+=len;
+
+    uint16_t palette[4];
+    glyph_palette(font, color, color_bcknd, palette);
+    uint8_t *dst=&self->gcache[e->offset];
+    for(uint8_t r=0; r<font->height; r++)
+    {
+        glyph_row(dst, font, glyph, w, gap, r, sizex, palette);
+        for(uint8_t s=1; s<sizey; s++)
+        {
+            memcpy(dst+s*row_len, dst, row_len);
+        }
+        dst+=row_len*sizey;
+    }
+    return &self->gcache[e->offset];
+}
+
+/*
+    char() | Intern Function. This function puts a single character on the screen.
+    tft, this function is a dependency of the text() function.
+    Returns the advance of the character: its width and the spacing of the font, scaled.
+    
+    CHANGELOG
+        Add a flag and add an extra color for the text background if required.
+        bool flag and uint16_t color_bcknd
+        With background the whole cell is rendered in a buffer and sent with a single window.
+        Without background each column is drawn as vertical runs of set bits instead of pixel by pixel.
+        Any font of tftdisp_font_t, gap columns of background are drawn after the glyph and the
+        characters with background come from the glyph cache when it is enabled.
+*/
+STATIC uint16_t charfunc(tftdisp_class_obj_t *self, const tftdisp_font_t *font, mp_int_t x, mp_int_t y, char ch, uint16_t color, uint8_t sizex, uint8_t sizey, bool flag, uint16_t color_bcknd, uint8_t gap)
+{
+    //Draw a character at a given position using a font, can be scaled with sizex and sizey.
+    if(!sizex || !sizey)
+    {
+        //this is by defect in the function uPython
+        sizex=1;
+        sizey=1;
+    }
+    uint8_t w;
+    const uint8_t *glyph=font_glyph(font, ch, &w);
+    uint16_t advance=(w+font->spacing)*sizex;
+    uint16_t cw=(w+gap)*sizex;
+    uint16_t chh=font->height*sizey;
+    uint16_t palette[4];
+    glyph_palette(font, color, color_bcknd, palette);
+
+    if(flag)
+    {
+        if(self->gcache!=NULL && self->dl==NULL)
+        {
+            const uint8_t *pixels=glyph_cache_get(self, font, ch, gap, sizex, sizey, color, color_bcknd);
+            if(pixels!=NULL)
+            {
+                //The transfer of the cached cell overlaps with the rendering of the next one
+                blit_int(self, x, y, cw, chh, pixels, false, false);
+                return advance;
+            }
+        }
+        if(!OFFSCREEN(self) && x>=0 && y>=0 && x+cw<=self->width && y+chh<=self->height && cw<=LINE_BUF_PIXELS)
+        {
+            //The whole cell goes to the display in a single window write
+            set_window(self, x, y, x+cw-1, y+chh-1);
+            for(uint8_t r=0; r<font->height; r++)
+            {
+                glyph_row(line_buf, font, glyph, w, gap, r, sizex, palette);
+                for(uint8_t s=0; s<sizey; s++)
+                {
+                    write_data(line_buf, cw*2);
+                }
+            }
+            return advance;
+        }
+        if(gap)
+        {
+            fill_rect(self, x+w*sizex, y, gap*sizex, chh, color_bcknd);
+        }
+        if(glyph==NULL)
+        {
+            fill_rect(self, x, y, w*sizex, chh, color_bcknd);
+        }
+    }
+    if(glyph==NULL)
+    {
+        // character not found in this font
+        return advance;
+    }
+
+    //Each column is drawn as vertical runs of the same level, scaled to the given sizes.
+    //Without background the anti-aliased pixels with at least half coverage take the text color.
+    uint8_t levels=(1<<font->bpp)-1;
+    for(uint8_t k=0; k<w; k++)
+    {
+        uint8_t i=0;
+        while(i<font->height)
+        {
+            uint8_t level=glyph_level(font, glyph, k, i);
+            uint8_t run=0;
+            while(i<font->height && glyph_level(font, glyph, k, i)==level)
+            {
+                run++;
+                i++;
+            }
+            if(flag)
+            {
+                fill_rect(self, x+k*sizex, y+(i-run)*sizey, sizex, run*sizey, palette[level]);
+            }
+            else if(2*level>levels)
+            {
+                fill_rect(self, x+k*sizex, y+(i-run)*sizey, sizex, run*sizey, color);
+            }
+        }
+    }
+    return advance;
+}
+
+/*
+    text_row() | Intern Function. Draws n characters with background color on a single text line using one window.
+    spacing columns of background go between the characters. Every row of the glyphs is rendered once
+    and sent size times.
+    Returns false when the row does not fit on the display so the caller can draw it character by character.
+*/
+STATIC bool text_row(tftdisp_class_obj_t *self, const tftdisp_font_t *font, mp_int_t x, mp_int_t y, const char *str, size_t n, uint8_t spacing, uint8_t size, uint16_t color, uint16_t color_bcknd)
+{
+    uint32_t w=0;
+    uint8_t gw;
+    for(size_t i=0; i<n; i++)
+    {
+        font_glyph(font, str[i], &gw);
+        w+=(gw+spacing)*size;
+    }
+    w-=spacing*size;
+    uint16_t h=font->height*size;
+    if(OFFSCREEN(self) || x<0 || y<0 || x+w>self->width || y+h>self->height || w>LINE_BUF_PIXELS)
+    {
+        return false;
+    }
+    uint16_t palette[4];
+    glyph_palette(font, color, color_bcknd, palette);
+    set_window(self, x, y, x+w-1, y+h-1);
+    for(uint8_t r=0; r<font->height; r++)
+    {
+        uint8_t *cell=line_buf;
+        for(size_t i=0; i<n; i++)
+        {
+            const uint8_t *glyph=font_glyph(font, str[i], &gw);
+            uint8_t gap=(i+1<n) ? spacing : 0;
+            glyph_row(cell, font, glyph, gw, gap, r, size, palette);
+            cell+=(gw+gap)*size*2;
+        }
+        for(uint8_t s=0; s<size; s++)
+        {
+            write_data(line_buf, w*2);
+        }
+    }
+    return true;
+}
+
+/*
+    text_int() | Intern Function. Draws the len characters of str at (x, y) with the font and size selected with font(),
+    wrapping at the right edge. str is not copied and may contain NUL bytes, drawn as the empty cell of the font.
+*/
+STATIC void text_int(tftdisp_class_obj_t *self, mp_int_t x, mp_int_t y, const char *string, size_t str_len, uint16_t color, bool flag, uint16_t color_bcknd)
+{
+    const tftdisp_font_t *font=fonts[self->font];
+    uint8_t size=self->font_size;
+    uint16_t line_h=(font->height+1)*size;
+    mp_int_t px=x;
+
+    for(size_t i=0; i<str_len && y<self->height; i++)
+    {
+        if(flag && px==x && self->gcache==NULL)
+        {
+            //Count the characters that fit in this line before the wrap
+            size_t n=1;
+            mp_int_t end=x+char_advance(font, string[i], size);
+            while(i+n<str_len && end+char_advance(font, string[i+n], size)<=self->width)
+            {
+                end+=char_advance(font, string[i+n], size);
+                n++;
+            }
+            if(text_row(self, font, px, y, &string[i], n, font->spacing, size, color, color_bcknd))
+            {
+                i+=n-1;
+                y+=line_h;
+                continue;
+            }
+        }
+        uint16_t advance=char_advance(font, string[i], size);
+        // wrap the text to the next line if it reaches the end
+        if(px!=x && px+advance>self->width)
+        {
+            y+=line_h;
+            px=x;
+        }
+        //The background between characters is only drawn inside a line
+        bool last=(i+1==str_len) || (px+advance+char_advance(font, string[i+1], size)>self->width);
+        px+=charfunc(self, font, px, y, string[i], color, size, size, flag, color_bcknd, last ? 0 : font->spacing);
+    }
+}
+
+/*
+    text() | This function displays text on the TFT display with the following parameters:
+        
+        -> x Position on the X-axis.
+        -> y Position on the Y-axis.
+        -> string Receiver variable of the text to print.
+        -> color Number that defines the color of the text.
+        Optional (Update)
+        -> flag token that receives a boolean value to activate the background.
+        -> color_bcknd desired background color.
+    The text uses the font and size selected with font().
+    With background every line of text is sent through a single window, or every character from the glyph
+    cache when glyph_cache() is enabled.
+*/
+STATIC mp_obj_t text(size_t n_args, const mp_obj_t *args)
+{
+    //Draw text at a given position using the user font.
+    //Font can be scaled with the size parameter.
+    
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t x = mp_obj_get_int(args[1]);
+    mp_int_t y = mp_obj_get_int(args[2]);
+
+    mp_check_self(mp_obj_is_str_or_bytes(args[3]));
+    GET_STR_DATA_LEN(args[3], str, str_len);
+    uint16_t color = mp_obj_get_int(args[4]);
+    bool flag=false;
+    uint16_t color_bcknd=65535;
+    
+    
+    if(n_args>5)
+    {
+        flag=mp_obj_get_int(args[5])? true : false;
+        color_bcknd=mp_obj_get_int(args[6]);
+    }
+    text_int(self, x, y, (const char *)str, str_len, color, flag, color_bcknd);
+    return mp_const_none;
+
+}
+
+/*
+    font() | Selects the font and the size used by text():
+        -> FONT_6X8 fixed 6x8 font, the default one.
+        -> FONT_PROP8 proportional 8 pixels font.
+        -> FONT_DIGITS24 anti-aliased 24 pixels font with digits, + - . : and space, for big readouts.
+    size scales the characters 1 to 8 times.
+    Example in uPython:
+        tft.font(tft.FONT_DIGITS24, 2)
+        tft.text(10, 40, "23.5", 0xFFFF, 1, 0)
+*/
+STATIC mp_obj_t set_font(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t id=mp_obj_get_int(args[1]);
+    mp_int_t size=(n_args>2) ? mp_obj_get_int(args[2]) : 1;
+    if(id<0 || id>=(mp_int_t)FONT_COUNT)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid font"));
+    }
+    if(size<1 || size>8)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("size must be 1 to 8"));
+    }
+    self->font=id;
+    self->font_size=size;
+    return mp_const_none;
+}
+
+/*
+    text_width() | Returns the width in pixels of a line of text with the font and size selected with font().
+    Useful to align the proportional fonts.
+    Example in uPython:
+        w=tft.text_width("23.5")
+        tft.text(160-w, 40, "23.5", 0xFFFF, 1, 0)
+*/
+STATIC mp_obj_t text_width(mp_obj_t self_in, mp_obj_t str_in)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    const tftdisp_font_t *font=fonts[self->font];
+    size_t len;
+    const char *str=mp_obj_str_get_data(str_in, &len);
+    mp_int_t w=0;
+    for(size_t i=0; i<len; i++)
+    {
+        w+=char_advance(font, str[i], self->font_size);
+    }
+    if(len>0)
+    {
+        w-=font->spacing*self->font_size;
+    }
+    return mp_obj_new_int(w);
+}
+
+/*
+    glyph_cache() | Reserves size bytes of RAM to keep the characters drawn by text() with background already
+    scaled and converted to RGB565, 0 frees it. A character takes width*height*size*size*2 bytes, 784 bytes
+    a digit of FONT_DIGITS24 at size 1. Repeated characters are then sent directly, with DMA, and the
+    rendering of the next character overlaps with the transfer.
+    Example in uPython:
+        tft.glyph_cache(8192)
+*/
+STATIC mp_obj_t glyph_cache(mp_obj_t self_in, mp_obj_t size_in)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_int_t size=mp_obj_get_int(size_in);
+    if(size<0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid size"));
+    }
+    glyph_cache_flush(self);
+    if(self->gcache!=NULL)
+    {
+        m_del(uint8_t, self->gcache, self->gcache_size);
+        self->gcache=NULL;
+        self->gcache_size=0;
+    }
+    if(size>0)
+    {
+        self->gcache=m_new(uint8_t, size);
+        self->gcache_size=size;
+    }
+    return mp_const_none;
+}
+
+/*
+    blit_int() | Intern Function. Draws a w*h RGB565 image from memory at (x, y), clipped against the display.
+    The image pixels are in panel byte order (high byte first) unless swap is true, in which case they are
+    in the native little-endian order of the MCU and are swapped row by row through line_buf.
+    When the image is not clipped horizontally it is sent in a single transfer, asynchronously if block is false.
+*/
+STATIC void blit_int(tftdisp_class_obj_t *self, mp_int_t x, mp_int_t y, mp_int_t w, mp_int_t h, const uint8_t *data, bool swap, bool block)
+{
+    if(self->dl!=NULL)
+    {
+        band_blit(self, x, y, w, h, data, swap, false);
+        return;
+    }
+    //Visible part of the image
+    mp_int_t x0=(x<0) ? 0 : x;
+    mp_int_t y0=(y<0) ? 0 : y;
+    mp_int_t x1=(x+w>self->width) ? self->width : x+w;
+    mp_int_t y1=(y+h>self->height) ? self->height : y+h;
+    if(x0>=x1 || y0>=y1)
+    {
+        return;
+    }
+    uint16_t cw=x1-x0;
+    uint16_t ch=y1-y0;
+    const uint8_t *src=data + ((y0-y)*w + (x0-x))*2;
+
+    if(self->fb!=NULL)
+    {
+        fb_sync(self);
+        for(uint16_t j=0; j<ch; j++)
+        {
+            uint8_t *dst=(uint8_t *)&self->fb[(y0+j)*self->width + x0];
+            if(swap)
+            {
+                for(uint16_t i=0; i<cw; i++)
+                {
+                    dst[2*i]=src[2*i+1];
+                    dst[2*i+1]=src[2*i];
+                }
+            }
+            else
+            {
+                memcpy(dst, src, cw*2);
+            }
+            src+=w*2;
+        }
+        fb_mark_dirty(self, x0, y0, x1-1, y1-1);
+        return;
+    }
+
+    set_window(self, x0, y0, x1-1, y1-1);
+    if(!swap && cw==w)
+    {
+        //The visible rows are contiguous, zero copy single transfer
+        if(block)
+        {
+            write_data((uint8_t *)src, cw*ch*2);
+        }
+        else
+        {
+            write_data_dma(src, cw*ch*2);
+        }
+        return;
+    }
+    for(uint16_t j=0; j<ch; j++)
+    {
+        if(swap)
+        {
+            for(uint16_t i=0; i<cw; i++)
+            {
+                line_buf[2*i]=src[2*i+1];
+                line_buf[2*i+1]=src[2*i];
+            }
+            write_data(line_buf, cw*2);
+        }
+        else
+        {
+            write_data((uint8_t *)src, cw*2);
+        }
+        src+=w*2;
+    }
+}
+
+/*
+    Largest width and height of blit(), w*h*2 and the stride w*2 of band_blit() can not overflow.
+*/
+#define BLIT_MAX    (32767)
+
+/*
+    blit_helper() | Intern Function. Parses the arguments (x, y, w, h, buf[, wait]) shared by blit() and blit_buffer().
+    buf can be any object with the buffer protocol (bytearray, memoryview, array) holding at least w*h pixels.
+*/
+STATIC mp_obj_t blit_helper(size_t n_args, const mp_obj_t *args, bool swap)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t x=mp_obj_get_int(args[1]);
+    mp_int_t y=mp_obj_get_int(args[2]);
+    mp_int_t w=mp_obj_get_int(args[3]);
+    mp_int_t h=mp_obj_get_int(args[4]);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[5], &bufinfo, MP_BUFFER_READ);
+    bool block=(n_args<7) || mp_obj_is_true(args[6]);
+    if(w>BLIT_MAX || h>BLIT_MAX)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("image too large"));
+    }
+    if(w<=0 || h<=0)
+    {
+        return mp_const_none;
+    }
+    if(bufinfo.len < (size_t)(w*h*2))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
+    if(x>=self->width || y>=self->height)
+    {
+        //Outside the display, x+w and y+h of the clipping can not overflow after this
+        return mp_const_none;
+    }
+    if(self->dl!=NULL)
+    {
+        //Recorded without copying the image, the buffer is kept alive until show()
+        if(self->band_refs==MP_OBJ_NULL)
+        {
+            self->band_refs=mp_obj_new_list(0, NULL);
+        }
+        mp_obj_list_append(self->band_refs, args[5]);
+        band_blit(self, x, y, w, h, bufinfo.buf, swap, true);
+        return mp_const_none;
+    }
+    if(!block)
+    {
+        dma_wait();
+        self->dma_ref=args[5];
+    }
+    blit_int(self, x, y, w, h, bufinfo.buf, swap, block);
+    return mp_const_none;
+}
+
+/*
+    blit() | Draws a w*h image at (x, y) from a buffer of RGB565 pixels in panel byte order (high byte first).
+    The image is clipped against the display. With wait=False the transfer runs with DMA in the background,
+    the buffer must not be modified until busy() returns False.
+    Example in uPython:
+        icon=bytearray(16*16*2)
+        tft.blit(10,20,16,16,icon)
+*/
+STATIC mp_obj_t blit(size_t n_args, const mp_obj_t *args)
+{
+    return blit_helper(n_args, args, false);
+}
+
+/*
+    blit_buffer() | Same as blit() but the pixels are RGB565 in the little-endian order used by the MCU,
+    for example the buffer of a framebuf.FrameBuffer created with framebuf.RGB565.
+    Example in uPython:
+        fbuf=framebuf.FrameBuffer(buf,32,32,framebuf.RGB565)
+        tft.blit_buffer(0,0,32,32,buf)
+*/
+STATIC mp_obj_t blit_buffer(size_t n_args, const mp_obj_t *args)
+{
+    return blit_helper(n_args, args, true);
+}
+
+/*
+    Opcodes of draw_list(). The values are little-endian 16 bit integers, coordinates are signed and clipped.
+*/
+#define DL_END      (0)     // end of the list, allows zero padded buffers
+#define DL_PIXEL    (1)     // x, y, color
+#define DL_RECT     (2)     // x, y, w, h, color
+#define DL_LINE     (3)     // x0, y0, x1, y1, color
+#define DL_TEXT     (4)     // x, y, color, color_bcknd, flag (1 byte), n (1 byte), n characters
+#define DL_BLIT     (5)     // x, y, w, h, w*h RGB565 pixels in panel byte order like blit()
+#define DL_BLIT_LE  (6)     // x, y, w, h, w*h RGB565 pixels in MCU byte order like blit_buffer()
+
+#define DL_I16(p)   ((int16_t)((p)[0] | ((p)[1]<<8)))
+
+/*
+    draw_list() | Executes a list of drawing commands packed in a buffer with a single call, without creating
+    Python objects for the arguments. Every command is an opcode byte followed by its values (see DL_*),
+    the list ends with the buffer or with DL_END. Returns the number of commands executed.
+    The commands are recorded like any other drawing function with the framebuffer or the band renderer.
+    Example in uPython:
+        import struct
+        cmds=bytearray()
+        cmds+=struct.pack("<Bhhhhh", tft.DL_RECT, 0, 0, 160, 20, 0x001F)
+        cmds+=struct.pack("<BhhHHBB", tft.DL_TEXT, 4, 6, 0xFFFF, 0x001F, 1, 5) + b"Speed"
+        cmds+=struct.pack("<Bhhhhh", tft.DL_LINE, 0, 20, 159, 20, 0xFFFF)
+        tft.draw_list(cmds)
+*/
+STATIC mp_obj_t draw_list(mp_obj_t self_in, mp_obj_t buf_in)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_READ);
+    const uint8_t *p=bufinfo.buf;
+    const uint8_t *end=p+bufinfo.len;
+    mp_int_t count=0;
+    while(p<end && p[0]!=DL_END)
+    {
+        uint8_t op=p[0];
+        size_t len;
+        switch(op)
+        {
+            case DL_PIXEL:
+                len=7;
+                break;
+            case DL_RECT:
+            case DL_LINE:
+                len=11;
+                break;
+            case DL_TEXT:
+                len=(end-p>=11) ? 11+p[10] : 11;
+                break;
+            case DL_BLIT:
+            case DL_BLIT_LE:
+                len=(end-p>=9 && DL_I16(&p[5])>0 && DL_I16(&p[7])>0) ? 9+(size_t)DL_I16(&p[5])*DL_I16(&p[7])*2 : 9;
+                break;
+            default:
+                mp_raise_ValueError(MP_ERROR_TEXT("invalid draw list opcode"));
+        }
+        if((size_t)(end-p)<len)
+        {
+            mp_raise_ValueError(MP_ERROR_TEXT("truncated draw list"));
+        }
+        const uint8_t *v=&p[1];
+        switch(op)
+        {
+            case DL_PIXEL:
+                if(DL_I16(&v[0])>=0 && DL_I16(&v[0])<self->width && DL_I16(&v[2])>=0 && DL_I16(&v[2])<self->height)
+                {
+                    pixel0(self, DL_I16(&v[0]), DL_I16(&v[2]), (uint16_t)DL_I16(&v[4]));
+                }
+                break;
+            case DL_RECT:
+                fill_rect(self, DL_I16(&v[0]), DL_I16(&v[2]), DL_I16(&v[4]), DL_I16(&v[6]), (uint16_t)DL_I16(&v[8]));
+                break;
+            case DL_LINE:
+                line_int(self, DL_I16(&v[0]), DL_I16(&v[2]), DL_I16(&v[4]), DL_I16(&v[6]), (uint16_t)DL_I16(&v[8]));
+                break;
+            case DL_TEXT:
+                text_int(self, DL_I16(&v[0]), DL_I16(&v[2]), (const char *)&v[10], v[9], (uint16_t)DL_I16(&v[4]),
+                    v[8]!=0, (uint16_t)DL_I16(&v[6]));
+                break;
+            default:
+                if(DL_I16(&v[4])>0 && DL_I16(&v[6])>0)
+                {
+                    blit_int(self, DL_I16(&v[0]), DL_I16(&v[2]), DL_I16(&v[4]), DL_I16(&v[6]), &v[8], op==DL_BLIT_LE, true);
+                }
+                break;
+        }
+        p+=len;
+        count++;
+    }
+    return mp_obj_new_int(count);
+}
+
+/*
+    clear() | This function clears the screen through the use of the rect_int() function in which it fills the screen with a color set by the user.
+    fills the screen with a color set by the user giving the effect of an empty screen. 
+*/
+STATIC mp_obj_t clear(mp_obj_t self_in, mp_obj_t color)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uint16_t color16b=mp_obj_get_int(color);
+    rect_int(self, 0, 0, self->width, self->height, color16b);
+    return mp_const_none;
+}
+
+/*
+    framebuffer() | Enables or disables the off-screen framebuffer, or returns its state when called without arguments.
+    While it is enabled the drawing functions only modify a width*height RGB565 buffer in RAM (40 KB for a 160x128 panel)
+    and nothing is sent to the display until show() is called.
+    Example in uPython:
+        tft.framebuffer(True)
+        tft.rect(10,20,50,60,tft.rgbcolor(23,0,254))
+        tft.show()
+*/
+STATIC mp_obj_t framebuffer(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if(n_args==1)
+    {
+        return mp_obj_new_bool(self->fb!=NULL);
+    }
+    if(mp_obj_is_true(args[1]))
+    {
+        if(self->dl!=NULL)
+        {
+            mp_raise_ValueError(MP_ERROR_TEXT("band renderer enabled"));
+        }
+        if(self->fb==NULL)
+        {
+            self->fb=m_new(uint16_t, self->width*self->height);
+            memset(self->fb, 0, self->width*self->height*sizeof(uint16_t));
+            self->dirty=false;
+        }
+    }
+    else if(self->fb!=NULL)
+    {
+        //The memory can not be released while DMA is still reading it
+        dma_wait();
+        m_del(uint16_t, self->fb, self->width*self->height);
+        self->fb=NULL;
+        self->fb_dma=false;
+        self->dirty=false;
+    }
+    return mp_const_none;
+}
+
+/*
+    band_render() | Intern Function. Renders the display list into the strip of w*h pixels at (x0, y0),
+    the pixels not covered by any primitive are black.
+*/
+STATIC void band_render(tftdisp_class_obj_t *self, uint8_t *strip, uint8_t x0, uint8_t y0, uint8_t w, uint8_t h)
+{
+    memset(strip, 0, w*h*2);
+    const uint8_t *p=self->dl;
+    const uint8_t *end=self->dl+self->dl_used;
+    while(p<end)
+    {
+        uint8_t rx=p[1];
+        uint8_t ry=p[2];
+        uint8_t rw=p[3];
+        uint8_t rh=p[4];
+        const uint8_t *next;
+        const uint8_t *src=NULL;
+        uint16_t stride=0;
+        bool swap=false;
+        if(p[0]==BAND_FILL)
+        {
+            next=p+7;
+        }
+        else
+        {
+            stride=p[6] | (p[7]<<8);
+            swap=(p[5]&BAND_SWAP)!=0;
+            if(p[5]&BAND_REF)
+            {
+                memcpy(&src, &p[8], sizeof(src));
+                next=p+8+sizeof(src);
+            }
+            else
+            {
+                src=&p[8];
+                next=p+8+rw*rh*2;
+            }
+        }
+        //Intersection of the primitive with the strip
+        uint8_t ix0=(rx>x0) ? rx : x0;
+        uint8_t iy0=(ry>y0) ? ry : y0;
+        uint16_t ix1=(rx+rw<x0+w) ? rx+rw : x0+w;
+        uint16_t iy1=(ry+rh<y0+h) ? ry+rh : y0+h;
+        if(ix0<ix1 && iy0<iy1)
+        {
+            uint16_t n=ix1-ix0;
+            for(uint16_t y=iy0; y<iy1; y++)
+            {
+                uint8_t *dst=&strip[((y-y0)*w + (ix0-x0))*2];
+                if(src==NULL)
+                {
+                    for(uint16_t i=0; i<n; i++)
+                    {
+                        dst[2*i]=p[5];
+                        dst[2*i+1]=p[6];
+                    }
+                }
+                else
+                {
+                    const uint8_t *s=src + (y-ry)*stride + (ix0-rx)*2;
+                    if(swap)
+                    {
+                        for(uint16_t i=0; i<n; i++)
+                        {
+                            dst[2*i]=s[2*i+1];
+                            dst[2*i+1]=s[2*i];
+                        }
+                    }
+                    else
+                    {
+                        memcpy(dst, s, n*2);
+                    }
+                }
+            }
+        }
+        p=next;
+    }
+}
+
+/*
+    band_show() | Intern Function. Renders the area covered by the display list band by band, the DMA transfer of
+    every band overlaps with the rendering of the next one in the other strip. The list is emptied.
+*/
+STATIC void band_show(tftdisp_class_obj_t *self, bool block)
+{
+    if(!self->dirty)
+    {
+        return;
+    }
+    //The strips may still be in use by the last band of the previous show()
+    dma_wait();
+    uint8_t x0=self->dirty_x0;
+    uint8_t w=self->dirty_x1-self->dirty_x0+1;
+    uint16_t y1=self->dirty_y1;
+    uint8_t lines=self->band_lines;
+    uint8_t k=0;
+    for(uint16_t y=self->dirty_y0; y<=y1; y+=lines, k++)
+    {
+        uint8_t h=(y+lines>y1+1) ? y1+1-y : lines;
+        uint8_t *strip=&self->band_buf[(k&0x01)*self->width*lines*2];
+        band_render(self, strip, x0, y, w, h);
+        //set_window() waits for the transfer of the previous band
+        set_window(self, x0, y, x0+w-1, y+h-1);
+        write_data_dma(strip, w*h*2);
+    }
+    self->dl_used=0;
+    self->band_refs=MP_OBJ_NULL;
+    self->dirty=false;
+    if(block)
+    {
+        dma_wait();
+    }
+}
+
+/*
+    band() | Starts the band renderer: a display list and two strips of lines rows replace the 40 KB framebuffer
+    (2*160*16*2 = 10 KB with 16 lines). The drawing functions are recorded and show() composes them and sends the
+    area they cover in a single pass without flicker. The area covered has to be painted completely every frame,
+    for example starting with clear() or rect(), the pixels without any primitive are sent black.
+    The buffers given to blit() must not change until show(). band(0) ends the band renderer.
+        -> lines rows of every strip, 1 to the height of the display.
+        -> size optional initial size of the display list in bytes, it grows when needed.
+    Example in uPython:
+        tft.band(16)
+        tft.clear(0)
+        tft.text(10, 10, "Speed", 0xFFFF)
+        tft.fill_circle(80, 70, 30, 0xF800)
+        tft.show()
+*/
+STATIC mp_obj_t band(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t lines=mp_obj_get_int(args[1]);
+    mp_int_t size=(n_args>2) ? mp_obj_get_int(args[2]) : BAND_LIST_SIZE;
+    band_free(self);
+    if(lines==0)
+    {
+        return mp_const_none;
+    }
+    if(lines<0 || lines>self->height || size<8)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid band size"));
+    }
+    if(self->fb!=NULL)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("framebuffer enabled"));
+    }
+    self->band_buf=m_new(uint8_t, 2*self->width*lines*2);
+    self->dl=m_new(uint8_t, size);
+    self->dl_size=size;
+    self->dl_used=0;
+    self->band_lines=lines;
+    self->dirty=false;
+    return mp_const_none;
+}
+
+/*
+    show() | Sends the area of the framebuffer modified since the last call to the display.
+    The union of all the dirty rectangles is written with a single RASET/CASET/RAMWR sequence.
+    show(False) starts the transfer with DMA and returns immediately, the area is widened to full rows
+    so it is contiguous in RAM. Use busy() or wait() before relying on the display contents. Drawing into the
+    framebuffer before the transfer ends waits for it, so the frame sent is never torn; work that does not draw
+    overlaps with the transfer.
+    With the band renderer enabled show() composes and sends the display list, see band().
+    Example in uPython:
+        tft.show(False)
+        compute_next_frame()
+        tft.wait()
+*/
+STATIC mp_obj_t show(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    bool block=(n_args<2) || mp_obj_is_true(args[1]);
+    if(self->dl!=NULL)
+    {
+        band_show(self, block);
+        return mp_const_none;
+    }
+    if(self->fb==NULL || !self->dirty)
+    {
+        return mp_const_none;
+    }
+    if(!block)
+    {
+        self->dirty_x0=0;
+        self->dirty_x1=self->width-1;
+    }
+    uint8_t w=self->dirty_x1-self->dirty_x0+1;
+    uint8_t h=self->dirty_y1-self->dirty_y0+1;
+    set_window(self, self->dirty_x0, self->dirty_y0, self->dirty_x1, self->dirty_y1);
+    if(!block)
+    {
+        write_data_dma((uint8_t *)&self->fb[self->dirty_y0*self->width], w*h*2);
+        self->fb_dma=true;
+    }
+    else if(w==self->width)
+    {
+        //Full rows are contiguous in RAM, so the whole area goes in one transfer
+        write_data((uint8_t *)&self->fb[self->dirty_y0*self->width], w*h*2);
+    }
+    else
+    {
+        for(uint8_t j=0; j<h; j++)
+        {
+            write_data((uint8_t *)&self->fb[(self->dirty_y0+j)*self->width + self->dirty_x0], w*2);
+        }
+    }
+    self->dirty=false;
+    return mp_const_none;
+}
+
+/*
+    read_ram() | Intern Function. Reads the w*h area at (x, y) of the display RAM into dest as RGB565 in panel byte order.
+    RAMRD returns a dummy byte and then 18 bits per pixel in 3 bytes whatever the interface format, and the read cycle
+    of the ST7735 is slower than the write cycle, so the bus runs with a prescaler of at least READ_PRESCALER.
+*/
+STATIC void read_ram(tftdisp_class_obj_t *self, uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t *dest)
+{
+    uint8_t rgb[3*READ_CHUNK];
+    uint32_t n=(uint32_t)w*h;
+    //The window ends with RAMWR, without data it does not modify the RAM
+    set_window(self, x, y, x+w-1, y+h-1);
+    if(self->prescaler<READ_PRESCALER)
+    {
+        spi_prescaler(READ_PRESCALER);
+    }
+    //The command and the data have to be in the same CS low period
+    mp_hal_pin_low(Pin_DC);
+    mp_hal_pin_low(Pin_CS);
+    uint8_t cmd=CMD_RAMRD;
+    spi_transfer(Spi_TFT, 1, &cmd, NULL, TIMEOUT_SPI);
+    mp_hal_pin_high(Pin_DC);
+    spi_transfer(Spi_TFT, 1, NULL, rgb, TIMEOUT_SPI);
+    while(n>0)
+    {
+        uint32_t k=(n>READ_CHUNK) ? READ_CHUNK : n;
+        spi_transfer(Spi_TFT, 3*k, NULL, rgb, TIMEOUT_SPI);
+        for(uint32_t i=0; i<k; i++)
+        {
+            uint16_t c=((rgb[3*i]&0xF8)<<8) | ((rgb[3*i+1]&0xFC)<<3) | (rgb[3*i+2]>>3);
+            *dest++=(uint8_t)(c>>8);
+            *dest++=(uint8_t)(c&0xFF);
+        }
+        n-=k;
+    }
+    mp_hal_pin_high(Pin_CS);
+    if(self->prescaler<READ_PRESCALER)
+    {
+        spi_prescaler(self->prescaler);
+    }
+}
+
+/*
+    read_helper() | Intern Function. Copies the w*h area at (x, y) to buf, or to a new bytearray if buf is MP_OBJ_NULL,
+    from the framebuffer when it is enabled and from the display RAM otherwise. Returns the buffer.
+*/
+STATIC mp_obj_t read_helper(tftdisp_class_obj_t *self, mp_int_t x, mp_int_t y, mp_int_t w, mp_int_t h, mp_obj_t buf)
+{
+    if(x<0 || y<0 || w<=0 || h<=0 || x+w>self->width || y+h>self->height)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("area outside the display"));
+    }
+    size_t len=w*h*2;
+    uint8_t *dest;
+    if(buf==MP_OBJ_NULL)
+    {
+        dest=m_new(uint8_t, len);
+        buf=mp_obj_new_bytearray_by_ref(len, dest);
+    }
+    else
+    {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(buf, &bufinfo, MP_BUFFER_WRITE);
+        if(bufinfo.len<len)
+        {
+            mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+        }
+        dest=bufinfo.buf;
+    }
+    if(self->fb!=NULL)
+    {
+        //The framebuffer is already in panel byte order
+        for(mp_int_t j=0; j<h; j++)
+        {
+            memcpy(&dest[j*w*2], &self->fb[(y+j)*self->width + x], w*2);
+        }
+    }
+    else
+    {
+        read_ram(self, x, y, w, h, dest);
+    }
+    return buf;
+}
+
+/*
+    read_rect() | Reads the w*h area at (x, y) as RGB565 in panel byte order, the format of blit(). Returns a new
+    bytearray or fills buf, which needs at least w*h*2 bytes. With the framebuffer enabled the pixels come from it,
+    including what has not been sent with show() yet, otherwise they are read from the display with RAMRD
+    (MISO connected, B4 on the Ophyra).
+    Example in uPython:
+        icon=tft.read_rect(10,20,16,16)
+        tft.blit(60,20,16,16,icon)
+*/
+STATIC mp_obj_t read_rect(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    return read_helper(self, mp_obj_get_int(args[1]), mp_obj_get_int(args[2]), mp_obj_get_int(args[3]),
+        mp_obj_get_int(args[4]), (n_args>5) ? args[5] : MP_OBJ_NULL);
+}
+
+/*
+    screenshot() | Reads the whole display like read_rect(), width*height*2 bytes (40 KB for 160x128).
+    To save it with less RAM read it in bands of rows with read_rect() and a reused buffer.
+    Example in uPython:
+        with open("screen.raw","wb") as f:
+            f.write(tft.screenshot())
+*/
+STATIC mp_obj_t screenshot(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    return read_helper(self, 0, 0, self->width, self->height, (n_args>1) ? args[1] : MP_OBJ_NULL);
+}
+
+/*
+    busy() | Returns True while an asynchronous DMA transfer to the display is still in progress.
+*/
+STATIC mp_obj_t busy(mp_obj_t self_in)
+{
+    return mp_obj_new_bool(dma_busy());
+}
+
+/*
+    wait() | Blocks until the asynchronous DMA transfer to the display (if any) has finished.
+*/
+STATIC mp_obj_t wait(mp_obj_t self_in)
+{
+    dma_wait();
+    return mp_const_none;
+}
+
+/*
+    Helpers to read the image files through the MicroPython VFS, so they work with the SD card and the internal flash.
+*/
+STATIC void file_read(mp_obj_t file, uint8_t *buf, size_t len)
+{
+    int errcode=0;
+    mp_uint_t out=mp_stream_rw(file, buf, len, &errcode, MP_STREAM_RW_READ);
+    if(errcode!=0)
+    {
+        mp_raise_OSError(errcode);
+    }
+    if(out!=len)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("image file truncated"));
+    }
+}
+
+STATIC void file_seek(mp_obj_t file, uint32_t offset)
+{
+    const mp_stream_p_t *stream_p=mp_get_stream(file);
+    struct mp_stream_seek_t seek_s;
+    seek_s.offset=offset;
+    seek_s.whence=MP_SEEK_SET;
+    int errcode;
+    if(stream_p->ioctl(file, MP_STREAM_SEEK, (uintptr_t)&seek_s, &errcode)==MP_STREAM_ERROR)
+    {
+        mp_raise_OSError(errcode);
+    }
+}
+
+#define LE16(p) ((uint16_t)((p)[0] | ((p)[1]<<8)))
+#define LE32(p) ((uint32_t)((p)[0] | ((p)[1]<<8) | ((p)[2]<<16) | ((uint32_t)(p)[3]<<24)))
+#define IMG_CHUNK   (96)
+
+/*
+    load_bmp() | Intern Function. Streams an uncompressed 8 (palette), 16 (RGB555 or RGB565), 24 or 32 bit BMP.
+    Each row is read in IMG_CHUNK byte pieces, converted to RGB565 into line_buf and drawn with blit_int(),
+    so the image is never held in the heap.
+*/
+STATIC void load_bmp(tftdisp_class_obj_t *self, mp_obj_t file, mp_int_t x, mp_int_t y)
+{
+    uint8_t header[54];
+    file_read(file, header, sizeof(header));
+    uint32_t offset=LE32(&header[10]);
+    uint32_t dib_size=LE32(&header[14]);
+    mp_int_t w=(int32_t)LE32(&header[18]);
+    mp_int_t h=(int32_t)LE32(&header[22]);
+    uint16_t bpp=LE16(&header[28]);
+    uint32_t compression=LE32(&header[30]);
+    bool top_down=h<0;
+    if(top_down)
+    {
+        h=-h;
+    }
+    if(w<=0 || w>LINE_BUF_PIXELS || (compression!=0 && compression!=3) || (bpp!=8 && bpp!=16 && bpp!=24 && bpp!=32))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("BMP format not supported"));
+    }
+
+    uint8_t chunk[IMG_CHUNK];
+    bool rgb555=(bpp==16);
+    uint16_t palette[256];
+    if(bpp==16 && compression==3)
+    {
+        //BI_BITFIELDS, the red mask tells RGB565 from RGB555
+        file_seek(file, 14+40);
+        file_read(file, chunk, 4);
+        rgb555=(LE32(chunk)==0x7C00);
+    }
+    if(bpp==8)
+    {
+        uint32_t colors=LE32(&header[46]);
+        if(colors==0 || colors>256)
+        {
+            colors=256;
+        }
+        //Indexes without a color in the file are drawn black
+        memset(palette, 0, sizeof(palette));
+        file_seek(file, 14+dib_size);
+        for(uint32_t i=0; i<colors; i++)
+        {
+            file_read(file, chunk, 4);
+            palette[i]=((chunk[2]&0xF8)<<8) | ((chunk[1]&0xFC)<<3) | (chunk[0]>>3);
+        }
+    }
+
+    uint8_t bytes_pp=bpp/8;
+    uint32_t stride=((w*bpp+31)/32)*4;
+    uint16_t px_per_chunk=IMG_CHUNK/bytes_pp;
+    file_seek(file, offset);
+    for(mp_int_t j=0; j<h; j++)
+    {
+        mp_int_t row=top_down ? y+j : y+h-1-j;
+        uint16_t i=0;
+        while(i<w)
+        {
+            uint16_t n=(w-i<px_per_chunk) ? w-i : px_per_chunk;
+            file_read(file, chunk, n*bytes_pp);
+            for(uint16_t k=0; k<n; k++)
+            {
+                const uint8_t *p=&chunk[k*bytes_pp];
+                uint16_t c;
+                if(bpp==8)
+                {
+                    c=palette[p[0]];
+                }
+                else if(bpp==16)
+                {
+                    c=LE16(p);
+                    if(rgb555)
+                    {
+                        c=((c&0x7FE0)<<1) | ((c>>4)&0x20) | (c&0x1F);
                     }
-                    py+=1;
-                    temp>>=1;
                 }
-                px+=1;
+                else
+                {
+                    c=((p[2]&0xF8)<<8) | ((p[1]&0xFC)<<3) | (p[0]>>3);
+                }
+                line_buf[2*(i+k)]=(uint8_t)(c>>8);
+                line_buf[2*(i+k)+1]=(uint8_t)(c&0xFF);
+            }
+            i+=n;
+        }
+        //Skip the padding to a multiple of 4 bytes
+        if(stride>(uint32_t)w*bytes_pp)
+        {
+            file_read(file, chunk, stride-w*bytes_pp);
+        }
+        blit_int(self, x, row, w, 1, line_buf, false, true);
+    }
+}
+
+/*
+    load_image() | Draws an image file at (x, y). The file can be a BMP (8, 16, 24 or 32 bits per pixel, uncompressed)
+    or raw RGB565 in panel byte order, in this case the width and height must be given.
+    The file is streamed row by row, the whole image is never loaded in RAM.
+    Example in uPython:
+        tft.load_image('/sd/logo.bmp', 0, 0)
+        tft.load_image('/flash/icon.raw', 10, 10, 32, 32)
+*/
+STATIC mp_obj_t load_image(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t x=(n_args>2) ? mp_obj_get_int(args[2]) : 0;
+    mp_int_t y=(n_args>3) ? mp_obj_get_int(args[3]) : 0;
+    mp_obj_t open_args[2]={args[1], MP_OBJ_NEW_QSTR(MP_QSTR_rb)};
+    //mp_builtin_open_obj is an alias of mp_vfs_open_obj on the ports with VFS
+    mp_obj_t file=mp_call_function_n_kw(MP_OBJ_FROM_PTR(&mp_builtin_open_obj), 2, 0, open_args);
+
+    nlr_buf_t nlr;
+    if(nlr_push(&nlr)==0)
+    {
+        uint8_t magic[2];
+        file_read(file, magic, sizeof(magic));
+        file_seek(file, 0);
+        if(magic[0]=='B' && magic[1]=='M')
+        {
+            load_bmp(self, file, x, y);
+        }
+        else
+        {
+            if(n_args<6)
+            {
+                mp_raise_ValueError(MP_ERROR_TEXT("width and height needed for raw images"));
+            }
+            mp_int_t w=mp_obj_get_int(args[4]);
+            mp_int_t h=mp_obj_get_int(args[5]);
+            if(w<=0 || w>LINE_BUF_PIXELS)
+            {
+                mp_raise_ValueError(MP_ERROR_TEXT("image too large"));
+            }
+            for(mp_int_t j=0; j<h; j++)
+            {
+                file_read(file, line_buf, w*2);
+                blit_int(self, x, y+j, w, 1, line_buf, false, true);
+            }
+        }
+        nlr_pop();
+    }
+    else
+    {
+        mp_stream_close(file);
+        nlr_jump(nlr.ret_val);
+    }
+    mp_stream_close(file);
+    return mp_const_none;
+}
+/*
+    Compressed sprites.
+
+    Format of the data (any object with the buffer protocol):
+        byte 0          width in pixels
+        byte 1          height in pixels
+        byte 2          number of colors in the palette, 1 to 16
+        next 2*n bytes  palette, RGB565 little-endian (struct.pack('<H', color))
+        rest            runs in raster order, a run can continue on the next row:
+                        high nibble = palette index, low nibble = length code L.
+                        L<15 is a run of L+1 pixels, L=15 is followed by a byte E and the run is 16+E pixels.
+    Runs of at least SPRITE_FILL_MIN pixels are sent with the fill engine, shorter runs are accumulated in line_buf.
+*/
+#define SPRITE_FILL_MIN (32)
+
+/*
+    sprite_next_run() | Intern Function. Decodes the run at *pos, returns its length and stores the palette index.
+*/
+STATIC uint16_t sprite_next_run(const uint8_t *data, size_t len, size_t *pos, uint8_t *index)
+{
+    if(*pos>=len)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("sprite data truncated"));
+    }
+    uint8_t b=data[(*pos)++];
+    *index=b>>4;
+    if((b&0x0F)<15)
+    {
+        return (b&0x0F)+1;
+    }
+    if(*pos>=len)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("sprite data truncated"));
+    }
+    return 16+data[(*pos)++];
+}
+
+/*
+    sprite() | Draws a palette and run length compressed sprite at (x, y), see the format above.
+    Example in uPython:
+        tft.sprite(10, 10, open('/flash/icon.spr','rb').read())
+*/
+STATIC mp_obj_t sprite(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t x=mp_obj_get_int(args[1]);
+    mp_int_t y=mp_obj_get_int(args[2]);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[3], &bufinfo, MP_BUFFER_READ);
+    const uint8_t *data=bufinfo.buf;
+    size_t len=bufinfo.len;
+    if(len<3 || data[2]==0 || data[2]>16 || len<3+2*(size_t)data[2])
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid sprite"));
+    }
+    uint8_t w=data[0];
+    uint8_t h=data[1];
+    uint8_t colors=data[2];
+    uint16_t palette[16];
+    for(uint8_t i=0; i<16; i++)
+    {
+        palette[i]=(i<colors) ? LE16(&data[3+2*i]) : 0;
+    }
+    size_t pos=3+2*colors;
+    uint32_t total=(uint32_t)w*h;
+    if(total==0)
+    {
+        return mp_const_none;
+    }
+
+    if(!OFFSCREEN(self) && x>=0 && y>=0 && x+w<=self->width && y+h<=self->height)
+    {
+        //Fully visible: one window for the whole sprite, runs are streamed into it
+        set_window(self, x, y, x+w-1, y+h-1);
+        uint16_t pending=0;
+        while(total>0)
+        {
+            uint8_t index;
+            uint32_t run=sprite_next_run(data, len, &pos, &index);
+            if(run>total)
+            {
+                run=total;
+            }
+            total-=run;
+            uint16_t color=palette[index];
+            if(run>=SPRITE_FILL_MIN)
+            {
+                if(pending>0)
+                {
+                    write_data(line_buf, pending*2);
+                    pending=0;
+                }
+                write_pixels(run, color);
+                continue;
+            }
+            while(run>0)
+            {
+                line_buf[2*pending]=(uint8_t)(color>>8);
+                line_buf[2*pending+1]=(uint8_t)(color&0xFF);
+                pending++;
+                run--;
+                if(pending==LINE_BUF_PIXELS)
+                {
+                    write_data(line_buf, pending*2);
+                    pending=0;
+                }
+            }
+        }
+        if(pending>0)
+        {
+            write_data(line_buf, pending*2);
+        }
+        return mp_const_none;
+    }
+
+    //Clipped or framebuffer: decode row by row and let blit_int() clip it
+    uint16_t col=0;
+    mp_int_t row=y;
+    while(total>0)
+    {
+        uint8_t index;
+        uint32_t run=sprite_next_run(data, len, &pos, &index);
+        if(run>total)
+        {
+            run=total;
+        }
+        total-=run;
+        uint16_t color=palette[index];
+        while(run>0)
+        {
+            line_buf[2*col]=(uint8_t)(color>>8);
+            line_buf[2*col+1]=(uint8_t)(color&0xFF);
+            col++;
+            run--;
+            if(col==w)
+            {
+                blit_int(self, x, row, w, 1, line_buf, false, true);
+                col=0;
+                row++;
             }
         }
-        else //scale to given sizes
+    }
+    return mp_const_none;
+}
+
+/*
+    Hardware scrolling.
+    The ST7735 scrolls along its RAM rows, the 160 pixel side of the panel. With init(1) (portrait) this is the
+    vertical axis of the screen, with the default landscape orientation the content moves horizontally.
+*/
+
+/*
+    scroll_area_int() | Intern Function. Defines the scrolling area with VSCRDEF, the fixed top and bottom areas
+    are the rest of the panel RAM rows. tfa counts from the first visible row, VSCRDEF and VSCSAD get RAM rows.
+*/
+STATIC void scroll_area_int(tftdisp_class_obj_t *self, uint8_t tfa, uint8_t vsa)
+{
+    //The rows of the panel before the visible ones are part of the fixed top area, like VSCSAD in scroll_int()
+    init_finish(self);
+    uint16_t ram_tfa=tfa + ram_row_offset(self);
+    uint16_t bfa=(ram_tfa+vsa<PANEL_RAM_ROWS) ? PANEL_RAM_ROWS-ram_tfa-vsa : 0;
+    write_cmd(CMD_VSCRDEF);
+    uint8_t data[]={(uint8_t)(ram_tfa>>8), (uint8_t)(ram_tfa&0xFF), 0x00, vsa, (uint8_t)(bfa>>8), (uint8_t)(bfa&0xFF)};
+    write_data(data, sizeof(data));
+    self->scroll_tfa=tfa;
+    self->scroll_vsa=vsa;
+}
+
+/*
+    scroll_int() | Intern Function. Sets the first RAM row of the scrolling area shown at its top with VSCSAD.
+*/
+STATIC void scroll_int(tftdisp_class_obj_t *self, uint8_t offset)
+{
+    init_finish(self);
+    uint8_t line=self->scroll_tfa + ram_row_offset(self) + (self->scroll_vsa ? offset%self->scroll_vsa : 0);
+    write_cmd(CMD_VSCSAD);
+    uint8_t data[]={0x00, line};
+    write_data(data, sizeof(data));
+}
+
+/*
+    scroll_area() | Defines the hardware scrolling area: tfa rows fixed at the top, vsa rows that scroll,
+    the rest of the rows stay fixed at the bottom.
+    Example in uPython:
+        tft.scroll_area(0, 160)
+*/
+STATIC mp_obj_t scroll_area(mp_obj_t self_in, mp_obj_t tfa, mp_obj_t vsa)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    scroll_area_int(self, mp_obj_get_int(tfa), mp_obj_get_int(vsa));
+    return mp_const_none;
+}
+
+/*
+    scroll() | Scrolls the area defined with scroll_area() so its row number offset is shown at the top.
+    Only two commands are sent, the display RAM is not rewritten.
+    Example in uPython:
+        for i in range(160):
+            tft.scroll(i)
+*/
+STATIC mp_obj_t scroll(mp_obj_t self_in, mp_obj_t offset)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    scroll_int(self, mp_obj_get_int(offset));
+    return mp_const_none;
+}
+
+/*
+    console_newline() | Intern Function. Moves the console cursor to the next line. On the last line the display is
+    scrolled by one text line and only the line that becomes visible at the bottom is cleared.
+*/
+STATIC void console_newline(tftdisp_class_obj_t *self)
+{
+    uint8_t rows=self->height/HEIGHT;
+    self->con_col=0;
+    if(self->con_row+1<rows)
+    {
+        self->con_row++;
+        return;
+    }
+    //The top line scrolls out and is reused as the new bottom line
+    rect_int(self, 0, self->con_top*HEIGHT, self->width, HEIGHT, self->con_bcknd);
+    self->con_top=(self->con_top+1)%rows;
+    scroll_int(self, self->con_top*HEIGHT);
+}
+
+/*
+    console_flush() | Intern Function. Draws n characters at the cursor position of the console.
+*/
+STATIC void console_flush(tftdisp_class_obj_t *self, const char *str, size_t n)
+{
+    if(n==0)
+    {
+        return;
+    }
+    uint8_t rows=self->height/HEIGHT;
+    uint8_t x=(self->con_col-n)*WIDTH;
+    uint8_t y=((self->con_top+self->con_row)%rows)*HEIGHT;
+    if(!text_row(self, &font_6x8, x, y, str, n, 0, 1, self->con_color, self->con_bcknd))
+    {
+        for(size_t i=0; i<n; i++)
+        {
+            charfunc(self, &font_6x8, x+i*WIDTH, y, str[i], self->con_color, 1, 1, true, self->con_bcknd, 0);
+        }
+    }
+}
+
+/*
+    console() | Starts the console mode: clears the display and uses the hardware scrolling to print a log,
+    write() only sends the characters it prints and scrolling costs a single cleared line.
+    The console needs the portrait orientation init(1), init(3) mirrors the rows of the RAM so it can not scroll them.
+    Example in uPython:
+        tft.init(1)
+        tft.console(tft.rgbcolor(0,255,0), 0)
+        tft.write('Sensor ready\n')
+*/
+STATIC mp_obj_t console(mp_obj_t self_in, mp_obj_t color, mp_obj_t color_bcknd)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if(self->madctl&(0x20|0x80))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("console needs the orientation of init(1)"));
+    }
+    self->con_color=mp_obj_get_int(color);
+    self->con_bcknd=mp_obj_get_int(color_bcknd);
+    self->con_col=0;
+    self->con_row=0;
+    self->con_top=0;
+    self->console_on=true;
+    rect_int(self, 0, 0, self->width, self->height, self->con_bcknd);
+    scroll_area_int(self, 0, self->height);
+    scroll_int(self, 0);
+    return mp_const_none;
+}
+
+/*
+    write() | Prints a string on the console started with console(), '\n' starts a new line and long lines wrap.
+*/
+STATIC mp_obj_t console_write(mp_obj_t self_in, mp_obj_t str_in)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if(!self->console_on)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("console not started"));
+    }
+    size_t len;
+    const char *str=mp_obj_str_get_data(str_in, &len);
+    uint8_t cols=self->width/WIDTH;
+    size_t start=0;
+    for(size_t i=0; i<len; i++)
+    {
+        char c=str[i];
+        if(c=='\n' || c=='\r' || self->con_col>=cols)
         {
-            for(uint8_t c=0;c<WIDTH;c++)
+            console_flush(self, &str[start], i-start);
+            start=i;
+            if(c=='\r')
             {
-                uint8_t py=y;
-
-                for(uint8_t i=0; i<HEIGHT;i++)
-                {
-                    if(ch[c]&0x01)
-                    {
-                        rect_int(self, px, py, sizex, sizey, color);
-                    }
-                    
-                    py+=sizey;
-                    c>>=1;
-                }
-                px+=sizex;
+                self->con_col=0;
+                start=i+1;
+                continue;
+            }
+            console_newline(self);
+            if(c=='\n')
+            {
+                start=i+1;
+                continue;
             }
         }
+        self->con_col++;
     }
-        // character not found in this font
-        return mp_const_none;
-} 
+    console_flush(self, &str[start], len-start);
+    return mp_const_none;
+}
 
 /*
-    text() | This function displays text on the TFT display with the following parameters:
-        
-        -> x Position on the X-axis.
-        -> y Position on the Y-axis.
-        -> string Receiver variable of the text to print.
-        -> color Number that defines the color of the text.
-        Optional (Update)
-        -> flag token that receives a boolean value to activate the background.
-        -> color_bcknd desired background color.
+    cells() | Starts the cell mode, a grid of characters of the 6x8 font for text screens. cell_text() only stores
+    the characters and refresh() draws the cells that changed, a line of changed cells with the same colors
+    goes through a single window. The grid fills the display: 26x16 cells in landscape with size 1.
+        -> color, color_bcknd initial colors of the cells, the display is cleared with color_bcknd.
+        -> size optional scale of the characters, 1 to 8.
+    cells(False) ends the cell mode and frees the grid.
+    Example in uPython:
+        tft.cells(0xFFFF, 0)
+        tft.cell_text(0, 0, "Temp:")
+        while True:
+            tft.cell_text(6, 0, "%5.1f" % temp)
+            tft.refresh()
 */
-STATIC mp_obj_t text(size_t n_args, const mp_obj_t *args)
+STATIC mp_obj_t cells(size_t n_args, const mp_obj_t *args)
 {
-    //Draw text at a given position using the user font.
-    //Font can be scaled with the size parameter.
-    
     tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
-    uint8_t x = mp_obj_get_int(args[1]);
-    uint8_t y = mp_obj_get_int(args[2]);
+    if(n_args==2 && mp_obj_is_true(args[1]))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("cells needs the text and background colors"));
+    }
+    mp_int_t size=(n_args>3) ? mp_obj_get_int(args[3]) : 1;
+    if(size<1 || size>8)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("size must be 1 to 8"));
+    }
+    if(self->cells!=NULL)
+    {
+        m_del(tftdisp_cell_t, self->cells, self->cell_cols*self->cell_rows);
+        self->cells=NULL;
+    }
+    if(n_args==2)
+    {
+        return mp_const_none;
+    }
 
-    mp_check_self(mp_obj_is_str_or_bytes(args[3]));
-    GET_STR_DATA_LEN(args[3], str, str_len);
-    char string[str_len];
-    strcpy(string, (char *)str);
-    uint16_t color = mp_obj_get_int(args[4]);
-    bool flag=false;
-    uint16_t color_bcknd=65535;
-    
-    
-    if(n_args>5)
+    uint16_t color=mp_obj_get_int(args[1]);
+    uint16_t color_bcknd=mp_obj_get_int(args[2]);
+    self->cell_size=size;
+    self->cell_cols=self->width/(WIDTH*size);
+    self->cell_rows=self->height/(HEIGHT*size);
+    size_t n=self->cell_cols*self->cell_rows;
+    self->cells=m_new(tftdisp_cell_t, n);
+    for(size_t i=0; i<n; i++)
     {
-        flag=mp_obj_get_int(args[5])? true : false;
-        color_bcknd=mp_obj_get_int(args[6]);
+        self->cells[i].ch=' ';
+        self->cells[i].dirty=false;
+        self->cells[i].color=color;
+        self->cells[i].color_bcknd=color_bcknd;
+    }
+    if(self->console_on)
+    {
+        //The grid is drawn without the hardware scrolling of the console
+        self->console_on=false;
+        scroll_int(self, 0);
+    }
+    rect_int(self, 0, 0, self->width, self->height, color_bcknd);
+    return mp_const_none;
+}
+
+/*
+    cell_text() | Writes a string in the grid of cells() from the cell (col, row), continuing in the next rows.
+    Nothing is drawn until refresh(), the cells that keep the same character and colors are not drawn again.
+        -> color, color_bcknd optional colors, by default every cell keeps its colors.
+    Example in uPython:
+        tft.cell_text(0, 2, "ALARM", tft.rgbcolor(255,0,0), 0)
+*/
+STATIC mp_obj_t cell_text(size_t n_args, const mp_obj_t *args)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if(self->cells==NULL)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("cells not started"));
+    }
+    mp_int_t col=mp_obj_get_int(args[1]);
+    mp_int_t row=mp_obj_get_int(args[2]);
+    size_t len;
+    const char *str=mp_obj_str_get_data(args[3], &len);
+    if(col<0 || col>=self->cell_cols || row<0 || row>=self->cell_rows)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("cell out of range"));
     }
-    uint8_t width=WIDTH+1;
-    uint8_t px=x;
+    bool colors=(n_args>5);
+    uint16_t color=colors ? mp_obj_get_int(args[4]) : 0;
+    uint16_t color_bcknd=colors ? mp_obj_get_int(args[5]) : 0;
 
-    for(uint8_t i=0;i<str_len;i++)
+    size_t n=self->cell_cols*self->cell_rows;
+    tftdisp_cell_t *cell=&self->cells[row*self->cell_cols+col];
+    for(size_t i=0; i<len && cell<&self->cells[n]; i++, cell++)
     {
-        charfunc(self, px, y, string[i], color, 1, 1, flag, color_bcknd);
-        px+=width;
-        // wrap the text to the next line if it reaches the end
-        if(px+width>self->width)
+        if(colors && (cell->color!=color || cell->color_bcknd!=color_bcknd))
         {
-            y+=HEIGHT+1;
-            px=x;
+            cell->color=color;
+            cell->color_bcknd=color_bcknd;
+            cell->dirty=true;
+        }
+        if(cell->ch!=str[i])
+        {
+            cell->ch=str[i];
+            cell->dirty=true;
         }
     }
     return mp_const_none;
+}
 
+/*
+    refresh() | Draws the cells changed since the last refresh() and returns how many were drawn.
+*/
+STATIC mp_obj_t refresh(mp_obj_t self_in)
+{
+    tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if(self->cells==NULL)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("cells not started"));
+    }
+    uint8_t size=self->cell_size;
+    uint16_t cw=WIDTH*size;
+    uint16_t chh=HEIGHT*size;
+    char run[LINE_BUF_PIXELS/WIDTH];
+    mp_int_t count=0;
+    for(uint8_t r=0; r<self->cell_rows; r++)
+    {
+        tftdisp_cell_t *line=&self->cells[r*self->cell_cols];
+        uint8_t c=0;
+        while(c<self->cell_cols)
+        {
+            if(!line[c].dirty)
+            {
+                c++;
+                continue;
+            }
+            //Run of changed cells with the same colors
+            uint8_t start=c;
+            uint8_t n=0;
+            while(c<self->cell_cols && line[c].dirty && n<sizeof(run)
+                && line[c].color==line[start].color && line[c].color_bcknd==line[start].color_bcknd)
+            {
+                run[n++]=line[c].ch;
+                line[c].dirty=false;
+                c++;
+            }
+            uint16_t color=line[start].color;
+            uint16_t color_bcknd=line[start].color_bcknd;
+            if(self->gcache!=NULL || !text_row(self, &font_6x8, start*cw, r*chh, run, n, 0, size, color, color_bcknd))
+            {
+                for(uint8_t k=0; k<n; k++)
+                {
+                    charfunc(self, &font_6x8, (start+k)*cw, r*chh, run[k], color, size, size, true, color_bcknd, 0);
+                }
+            }
+            count+=n;
+        }
+    }
+    return mp_obj_new_int(count);
 }
+
+#if TFTDISP_EMULATOR
 /*
-    clear() | This function clears the screen through the use of the rect_int() function in which it fills the screen with a color set by the user.
-    fills the screen with a color set by the user giving the effect of an empty screen. 
+    emu_dump() | Only in the unix port. Saves what the emulated display shows as a PPM image, or PNG if the name ends with ".png".
+    Example in uPython:
+        tft.emu_dump("screen.png")
 */
-STATIC mp_obj_t clear(mp_obj_t self_in, mp_obj_t color)
+STATIC mp_obj_t emu_dump(mp_obj_t self_in, mp_obj_t path_in)
 {
     tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    uint16_t color16b=mp_obj_get_int(color);
-    rect_int(self, 0, 0, self->width, self->height, color16b);
+    dma_wait();
+    if(!tftdisp_emu_dump(mp_obj_str_get_str(path_in), self->margin_col, self->margin_row, self->width, self->height))
+    {
+        mp_raise_OSError(MP_EIO);
+    }
     return mp_const_none;
 }
 
 /*
-  show_image()  | Function in progress
+    emu_stats() | Only in the unix port. Returns the SPI traffic sent to the emulated display since the last emu_reset_stats():
+    (transactions, commands, bytes, pixels). A transaction is every time CS goes low.
+    Example in uPython:
+        tft.emu_reset_stats()
+        tft.text(0, 0, "Hola", 0xFFFF, 1, 0)
+        print(tft.emu_stats())
 */
-// STATIC mp_obj_t show_image(size_t n_args, const mp_obj_t *args)
-// {
-//     tftdisp_class_obj_t *self = MP_OBJ_TO_PTR(args[0]);
-//     uint8_t x=mp_obj_get_int(args[1]);
-//     uint8_t y=mp_obj_get_int(args[2]);
-//     mp_check_self(mp_obj_is_str_or_bytes(args[3]));
-//     GET_STR_DATA_LEN(args[3], str, str_len);
-//     char file[str_len];
-//     strcpy(file, (char *)str);
-    
-//     printf("Hago uso de valores para leer el epacio de la micro SD \n");
-//     FATFS fatfs;    ///Archivo del sistema para el driver (SD)
-//     FIL fil;        //Estructura del objeto de archivo
-//     FRESULT fresult;///Retorno de ejecucion de funciones (Enum definidos)
-//     UINT testBytes; //Variable entera de 32 bits sin signo
-
-//     uint8_t BMInfo_Buffer[54];
-//     uint16_t PointerImage=0;
-//     uint16_t HeightImg, WideImg;
-
-//     //init the use of FS
-//     //This function registers/unregisters a filesystem object
-//     fresult=f_mount(&fatfs);
-//     printf("Monto la SD\n");
-// 	if(fresult == FR_OK){
-// 		//This function opens a file and sets the write/read pointer to zero
-//         printf("Todo OK, Voy a abrir el archivo %s \n",file);
-// 		fresult = f_open(&fatfs ,&fil , file, FA_READ | FA_WRITE);
-// 		if(fresult == FR_OK){ 			//checking if a file is open correctly
-// 			fresult = f_lseek(&fil, 0); //Pointing to begin of file BMP.
-//             printf("Voy a posicionarme la posicion 0 del archivo\n");
-// 			// Getting all the parameters of the file BMP.
-// 			// Reads a firts 54 bytes of file and saves in BMInfo_Buffer.
-// 			fresult = f_read(&fil, BMInfo_Buffer, sizeof(BMInfo_Buffer), &testBytes);
-//             printf("Voy a leer el archivo\n");
-// 			//In this conditional it's verified the "BM" nature of the file
-// 			if (BMInfo_Buffer[0] == 'B' && BMInfo_Buffer[1] == 'M'){
-// 				//extracting size of image.
-// 				HeightImg = (BMInfo_Buffer[19] << 8 | BMInfo_Buffer[18]);
-// 				WideImg = (BMInfo_Buffer[23] << 8 | BMInfo_Buffer[22]);
-// 				if(HeightImg<=160 && WideImg<=128){//checking size of image.
-// 					if(BMInfo_Buffer[28]==8){ //checking the format codifying of the pixels
-// 						/*Here two variables are created:
-// 						 *Line_Buffer: store the 160 numbers, those bytes point to ColorMAP_Buffer.
-// 						 *Image_Line_RGB: will store the 480 numbers, those are bytes information RGB to print in screen.*/
-// 						uint8_t Line_Buffer[BMInfo_Buffer[18]];
-// 						uint8_t Image_Line_RGB[BMInfo_Buffer[18]*3];
-// 						uint8_t ColorMap_Buffer[1024];
-// 						// Get the color map
-// 						fresult = f_lseek(&fil, 54);
-// 						fresult = f_read(&fil, ColorMap_Buffer, sizeof(ColorMap_Buffer), &testBytes);
-// 						// This for cycle will run many times as the height of the image
-// 						for (uint8_t j = 0; j<BMInfo_Buffer[22]; j++)
-// 						{
-// 							//This pointer it's use to get the information inside the Line buffer
-// 							PointerImage = 0;
-// 							//Get the line N
-// 							fresult = f_lseek(&fil, 1078+(BMInfo_Buffer[18]*j));
-// 							fresult = f_read(&fil, Line_Buffer, sizeof(Line_Buffer), &testBytes);
-// 							//In this for cycle it's created the line tha will be printed in Ophyra's TFT---
-// 							for(uint16_t i = 0; i < sizeof(Image_Line_RGB); i=i+3)
-// 							{
-// 								Image_Line_RGB[i+2] = ColorMap_Buffer[(Line_Buffer[PointerImage])*4];
-
-// 								Image_Line_RGB[i+1] = ColorMap_Buffer[(Line_Buffer[PointerImage]*4)+1];
-
-// 								Image_Line_RGB[i] = ColorMap_Buffer[(Line_Buffer[PointerImage]*4)+2];
-
-// 								PointerImage++;
-// 							}
-// 							//-------------------------Prints the line N on Ophyra's TF-------------------
-// 							pstImgdesc.pu8Img = Image_Line_RGB;
-// 							pstImgdesc.u8XSize = BMInfo_Buffer[18];
-// 							pstImgdesc.u8YSize = 1;
-// 							pstImgdesc.u8XCursor = x;
-// 							pstImgdesc.u8YCursor = y + (BMInfo_Buffer[22] - j - 1);
-// 							drawImg(self ,&pstImgdesc);
-// 							//----------------------------------------------------------------------------
-// 						}
-
-// 					}else if(BMInfo_Buffer[28]==24){
-// 						/*Here two variables are created:
-// 						 *Line_Buffer: store the 160 numbers, those bytes point to ColorMAP_Buffer.*/
-// 						uint8_t Image_Line_RGB[BMInfo_Buffer[18]*3];
-// 						// This for cycle will run many times as the height of the image
-// 						for (uint8_t j = 0; j<BMInfo_Buffer[22]; j++)
-// 						{//Get the line N
-// 							fresult = f_lseek(&fil, 54+(3*BMInfo_Buffer[18]*j));
-// 							fresult = f_read(&fil, Image_Line_RGB, sizeof(Image_Line_RGB), &testBytes);
-// 							//-------------------------Prints the line N on Ophyra's TF-------------------
-// 							for(uint16_t i=0; i < sizeof(Image_Line_RGB); i=i+3)
-// 							{
-// 								uint8_t tempo = Image_Line_RGB[i];
-// 								Image_Line_RGB[i] = Image_Line_RGB[i+2];
-// 								Image_Line_RGB[i+2] = tempo;
-// 							}
-// 							pstImgdesc.pu8Img = Image_Line_RGB;
-// 							pstImgdesc.u8XSize = BMInfo_Buffer[18];
-// 							pstImgdesc.u8YSize = 1;
-// 							pstImgdesc.u8XCursor = x;
-// 							pstImgdesc.u8YCursor = y + (BMInfo_Buffer[22] - j - 1);
-// 							drawImg(self, &pstImgdesc);
-// 							//----------------------------------------------------------------------------
-// 						}
-// 					}else{
-// 						printf("Error only 8 or 24 bit supported");
-// 					}
-// 				}else{
-// 					printf("Error image too large");
-// 				}
-// 			}else{
-// 				printf("Error Image is not a BMP");
-// 			}
-// 		}else{
-// 			printf("Error Image not found!");
-// 		}
-// 	}
-// 	else{
-// 		printf("Error SD no mount");
-// 	}
-// 	if(fresult == FR_OK){
-// 		fresult = f_close(&fil);//This function close an open file
-//         printf("Cerre el archivo\n");
-// 	}    
-//     return mp_const_none;
-
-// }
+STATIC mp_obj_t emu_stats(mp_obj_t self_in)
+{
+    mp_obj_t stats[4]={
+        mp_obj_new_int_from_uint(tftdisp_emu_stats.transactions),
+        mp_obj_new_int_from_uint(tftdisp_emu_stats.commands),
+        mp_obj_new_int_from_uint(tftdisp_emu_stats.bytes),
+        mp_obj_new_int_from_uint(tftdisp_emu_stats.pixels),
+    };
+    return mp_obj_new_tuple(4, stats);
+}
+
+STATIC mp_obj_t emu_reset_stats(mp_obj_t self_in)
+{
+    memset(&tftdisp_emu_stats, 0, sizeof(tftdisp_emu_stats));
+    return mp_const_none;
+}
+#endif
+
 //The above functions are associated with their corresponding Micropython function object.
-MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(st7735_init_obj, 1, 2, st7735_init);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(st7735_init_obj, 1, 3, st7735_init);
+MP_DEFINE_CONST_FUN_OBJ_1(ready_obj, ready);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(convert_obj, 4, 6, convert);
 MP_DEFINE_CONST_FUN_OBJ_2(inverted_obj, inverted);
 MP_DEFINE_CONST_FUN_OBJ_2(power_obj, power);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(prescaler_obj, 1, 2, prescaler);
+MP_DEFINE_CONST_FUN_OBJ_1(benchmark_obj, benchmark);
 MP_DEFINE_CONST_FUN_OBJ_2(backlight_obj, backlight);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(partial_obj, 1, 3, partial);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(idle_obj, 1, 2, idle);
 MP_DEFINE_CONST_FUN_OBJ_VAR(rgbcolor_obj, 4, rgbcolor);
 MP_DEFINE_CONST_FUN_OBJ_VAR(pixel_obj, 4, pixel);
 MP_DEFINE_CONST_FUN_OBJ_VAR(rect_obj, 6, rect);
 MP_DEFINE_CONST_FUN_OBJ_VAR(line_obj, 6, line);
+MP_DEFINE_CONST_FUN_OBJ_VAR(circle_obj, 5, circle);
+MP_DEFINE_CONST_FUN_OBJ_VAR(fill_circle_obj, 5, fill_circle);
+MP_DEFINE_CONST_FUN_OBJ_VAR(triangle_obj, 8, triangle);
+MP_DEFINE_CONST_FUN_OBJ_VAR(fill_triangle_obj, 8, fill_triangle);
+MP_DEFINE_CONST_FUN_OBJ_3(polygon_obj, polygon);
+MP_DEFINE_CONST_FUN_OBJ_3(fill_polygon_obj, fill_polygon);
+MP_DEFINE_CONST_FUN_OBJ_VAR(round_rect_obj, 7, round_rect);
+MP_DEFINE_CONST_FUN_OBJ_VAR(fill_round_rect_obj, 7, fill_round_rect);
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(text_obj, 5, 7, text);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(font_obj, 2, 3, set_font);
+MP_DEFINE_CONST_FUN_OBJ_2(text_width_obj, text_width);
+MP_DEFINE_CONST_FUN_OBJ_2(glyph_cache_obj, glyph_cache);
 MP_DEFINE_CONST_FUN_OBJ_2(clear_obj, clear);
-// MP_DEFINE_CONST_FUN_OBJ_VAR(show_image_obj, 4, show_image);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(blit_obj, 6, 7, blit);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(blit_buffer_obj, 6, 7, blit_buffer);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuffer_obj, 1, 2, framebuffer);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(show_obj, 1, 2, show);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(band_obj, 2, 3, band);
+MP_DEFINE_CONST_FUN_OBJ_2(draw_list_obj, draw_list);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(read_rect_obj, 5, 6, read_rect);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(screenshot_obj, 1, 2, screenshot);
+MP_DEFINE_CONST_FUN_OBJ_1(busy_obj, busy);
+MP_DEFINE_CONST_FUN_OBJ_1(wait_obj, wait);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(load_image_obj, 2, 6, load_image);
+MP_DEFINE_CONST_FUN_OBJ_VAR(sprite_obj, 4, sprite);
+MP_DEFINE_CONST_FUN_OBJ_3(scroll_area_obj, scroll_area);
+MP_DEFINE_CONST_FUN_OBJ_2(scroll_obj, scroll);
+MP_DEFINE_CONST_FUN_OBJ_3(console_obj, console);
+MP_DEFINE_CONST_FUN_OBJ_2(console_write_obj, console_write);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(cells_obj, 2, 4, cells);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(cell_text_obj, 4, 6, cell_text);
+MP_DEFINE_CONST_FUN_OBJ_1(refresh_obj, refresh);
+#if TFTDISP_EMULATOR
+MP_DEFINE_CONST_FUN_OBJ_2(emu_dump_obj, emu_dump);
+MP_DEFINE_CONST_FUN_OBJ_1(emu_stats_obj, emu_stats);
+MP_DEFINE_CONST_FUN_OBJ_1(emu_reset_stats_obj, emu_reset_stats);
+#endif
 /*
     The Micropython function object is associated with a certain string, which will be used in Micropython programming.
     Micropython programming. Ex: If you write:
@@ -1105,16 +3960,68 @@ MP_DEFINE_CONST_FUN_OBJ_2(clear_obj, clear);
 */
 STATIC const mp_rom_map_elem_t tftdisp_class_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_init), MP_ROM_PTR(&st7735_init_obj) },
+    { MP_ROM_QSTR(MP_QSTR_ready), MP_ROM_PTR(&ready_obj) },
+    { MP_ROM_QSTR(MP_QSTR_convert), MP_ROM_PTR(&convert_obj) },
     { MP_ROM_QSTR(MP_QSTR_inverted), MP_ROM_PTR(&inverted_obj) },
     { MP_ROM_QSTR(MP_QSTR_power), MP_ROM_PTR(&power_obj) },
+    { MP_ROM_QSTR(MP_QSTR_prescaler), MP_ROM_PTR(&prescaler_obj) },
+    { MP_ROM_QSTR(MP_QSTR_benchmark), MP_ROM_PTR(&benchmark_obj) },
     { MP_ROM_QSTR(MP_QSTR_backlight), MP_ROM_PTR(&backlight_obj) },
+    { MP_ROM_QSTR(MP_QSTR_partial), MP_ROM_PTR(&partial_obj) },
+    { MP_ROM_QSTR(MP_QSTR_idle), MP_ROM_PTR(&idle_obj) },
     { MP_ROM_QSTR(MP_QSTR_rgbcolor), MP_ROM_PTR(&rgbcolor_obj) },
     { MP_ROM_QSTR(MP_QSTR_pixel), MP_ROM_PTR(&pixel_obj) },
     { MP_ROM_QSTR(MP_QSTR_rect), MP_ROM_PTR(&rect_obj) },
     { MP_ROM_QSTR(MP_QSTR_line), MP_ROM_PTR(&line_obj) },
+    { MP_ROM_QSTR(MP_QSTR_circle), MP_ROM_PTR(&circle_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fill_circle), MP_ROM_PTR(&fill_circle_obj) },
+    { MP_ROM_QSTR(MP_QSTR_triangle), MP_ROM_PTR(&triangle_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fill_triangle), MP_ROM_PTR(&fill_triangle_obj) },
+    { MP_ROM_QSTR(MP_QSTR_polygon), MP_ROM_PTR(&polygon_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fill_polygon), MP_ROM_PTR(&fill_polygon_obj) },
+    { MP_ROM_QSTR(MP_QSTR_round_rect), MP_ROM_PTR(&round_rect_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fill_round_rect), MP_ROM_PTR(&fill_round_rect_obj) },
     { MP_ROM_QSTR(MP_QSTR_text), MP_ROM_PTR(&text_obj) },
+    { MP_ROM_QSTR(MP_QSTR_font), MP_ROM_PTR(&font_obj) },
+    { MP_ROM_QSTR(MP_QSTR_text_width), MP_ROM_PTR(&text_width_obj) },
+    { MP_ROM_QSTR(MP_QSTR_glyph_cache), MP_ROM_PTR(&glyph_cache_obj) },
+    { MP_ROM_QSTR(MP_QSTR_FONT_6X8), MP_ROM_INT(0) },
+    { MP_ROM_QSTR(MP_QSTR_FONT_PROP8), MP_ROM_INT(1) },
+    { MP_ROM_QSTR(MP_QSTR_FONT_DIGITS24), MP_ROM_INT(2) },
+    { MP_ROM_QSTR(MP_QSTR_DL_PIXEL), MP_ROM_INT(DL_PIXEL) },
+    { MP_ROM_QSTR(MP_QSTR_DL_RECT), MP_ROM_INT(DL_RECT) },
+    { MP_ROM_QSTR(MP_QSTR_DL_LINE), MP_ROM_INT(DL_LINE) },
+    { MP_ROM_QSTR(MP_QSTR_DL_TEXT), MP_ROM_INT(DL_TEXT) },
+    { MP_ROM_QSTR(MP_QSTR_DL_BLIT), MP_ROM_INT(DL_BLIT) },
+    { MP_ROM_QSTR(MP_QSTR_DL_BLIT_LE), MP_ROM_INT(DL_BLIT_LE) },
+    { MP_ROM_QSTR(MP_QSTR_RGB888), MP_ROM_INT(CONV_RGB888) },
+    { MP_ROM_QSTR(MP_QSTR_GRAY8), MP_ROM_INT(CONV_GRAY8) },
+    { MP_ROM_QSTR(MP_QSTR_MONO), MP_ROM_INT(CONV_MONO) },
     { MP_ROM_QSTR(MP_QSTR_clear), MP_ROM_PTR(&clear_obj) },
-    // { MP_ROM_QSTR(MP_QSTR_show_image), MP_ROM_PTR(&show_image_obj) },
+    { MP_ROM_QSTR(MP_QSTR_blit), MP_ROM_PTR(&blit_obj) },
+    { MP_ROM_QSTR(MP_QSTR_blit_buffer), MP_ROM_PTR(&blit_buffer_obj) },
+    { MP_ROM_QSTR(MP_QSTR_framebuffer), MP_ROM_PTR(&framebuffer_obj) },
+    { MP_ROM_QSTR(MP_QSTR_show), MP_ROM_PTR(&show_obj) },
+    { MP_ROM_QSTR(MP_QSTR_band), MP_ROM_PTR(&band_obj) },
+    { MP_ROM_QSTR(MP_QSTR_draw_list), MP_ROM_PTR(&draw_list_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read_rect), MP_ROM_PTR(&read_rect_obj) },
+    { MP_ROM_QSTR(MP_QSTR_screenshot), MP_ROM_PTR(&screenshot_obj) },
+    { MP_ROM_QSTR(MP_QSTR_busy), MP_ROM_PTR(&busy_obj) },
+    { MP_ROM_QSTR(MP_QSTR_wait), MP_ROM_PTR(&wait_obj) },
+    { MP_ROM_QSTR(MP_QSTR_load_image), MP_ROM_PTR(&load_image_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sprite), MP_ROM_PTR(&sprite_obj) },
+    { MP_ROM_QSTR(MP_QSTR_scroll_area), MP_ROM_PTR(&scroll_area_obj) },
+    { MP_ROM_QSTR(MP_QSTR_scroll), MP_ROM_PTR(&scroll_obj) },
+    { MP_ROM_QSTR(MP_QSTR_console), MP_ROM_PTR(&console_obj) },
+    { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&console_write_obj) },
+    { MP_ROM_QSTR(MP_QSTR_cells), MP_ROM_PTR(&cells_obj) },
+    { MP_ROM_QSTR(MP_QSTR_cell_text), MP_ROM_PTR(&cell_text_obj) },
+    { MP_ROM_QSTR(MP_QSTR_refresh), MP_ROM_PTR(&refresh_obj) },
+#if TFTDISP_EMULATOR
+    { MP_ROM_QSTR(MP_QSTR_emu_dump), MP_ROM_PTR(&emu_dump_obj) },
+    { MP_ROM_QSTR(MP_QSTR_emu_stats), MP_ROM_PTR(&emu_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_emu_reset_stats), MP_ROM_PTR(&emu_reset_stats_obj) },
+#endif
     //Name of the func. to be invoked in Python     Pointer to the object of the func. to be invoked.
 };
                                 
@@ -1128,11 +4035,366 @@ const mp_obj_type_t tftdisp_class_type = {
     .locals_dict = (mp_obj_dict_t*)&tftdisp_class_locals_dict,
 };
 
+/*
+    Widgets: Bar, Gauge and Plot draw on an ST7735 and keep what they drew, update() only sends the pixels
+    that change with the new value. All of them take the same arguments:
+        -> tft ST7735 object where the widget is drawn.
+        -> x, y, w, h area of the widget.
+        -> vmin, vmax range of the values.
+        -> color, color_bcknd colors of the widget and of its background.
+    draw() paints the whole widget again, after clearing the display for example.
+*/
+#define WIDGET_BAR      (0)
+#define WIDGET_GAUGE    (1)
+#define WIDGET_PLOT     (2)
+#define PLOT_EMPTY      (0xFF)
+
+typedef struct _tftdisp_widget_obj_t {
+    mp_obj_base_t base;
+    tftdisp_class_obj_t *tft;
+    uint8_t kind;
+    mp_int_t x;
+    mp_int_t y;
+    mp_int_t w;
+    mp_int_t h;
+    mp_float_t vmin;
+    mp_float_t vmax;
+    uint16_t color;
+    uint16_t color_bcknd;
+    // Position drawn for the last value: length of the bar or step of the needle, -1 before the first update()
+    mp_int_t level;
+    // Plot: rows of the trace in every column (2 bytes, top and bottom), column of the next sample and its last row
+    uint8_t *span;
+    mp_int_t cursor;
+    mp_int_t last_row;
+} tftdisp_widget_obj_t;
+
+const mp_obj_type_t tftdisp_bar_type;
+const mp_obj_type_t tftdisp_gauge_type;
+const mp_obj_type_t tftdisp_plot_type;
+
+STATIC mp_obj_t widget_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args, uint8_t kind)
+{
+    mp_arg_check_num(n_args, n_kw, 9, 9, false);
+    if(!mp_obj_is_type(args[0], &tftdisp_class_type))
+    {
+        mp_raise_TypeError(MP_ERROR_TEXT("expecting an ST7735"));
+    }
+    tftdisp_widget_obj_t *self=m_new_obj(tftdisp_widget_obj_t);
+    self->base.type=type;
+    self->tft=MP_OBJ_TO_PTR(args[0]);
+    self->kind=kind;
+    self->x=mp_obj_get_int(args[1]);
+    self->y=mp_obj_get_int(args[2]);
+    self->w=mp_obj_get_int(args[3]);
+    self->h=mp_obj_get_int(args[4]);
+    self->vmin=mp_obj_get_float(args[5]);
+    self->vmax=mp_obj_get_float(args[6]);
+    self->color=mp_obj_get_int(args[7]);
+    self->color_bcknd=mp_obj_get_int(args[8]);
+    self->level=-1;
+    self->span=NULL;
+    if(self->w<3 || self->h<3 || self->w>255 || self->h>255 || self->vmax==self->vmin)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid widget size or range"));
+    }
+    if(kind==WIDGET_GAUGE && (self->w<4 || self->h<4))
+    {
+        //Smaller dials have a radius of 0 and no steps for the needle
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid widget size or range"));
+    }
+    if(kind==WIDGET_PLOT)
+    {
+        self->span=m_new(uint8_t, 2*self->w);
+        memset(self->span, PLOT_EMPTY, 2*self->w);
+        self->cursor=0;
+        self->last_row=-1;
+    }
+    return MP_OBJ_FROM_PTR(self);
+}
+
+STATIC mp_obj_t bar_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args)
+{
+    return widget_make_new(type, n_args, n_kw, args, WIDGET_BAR);
+}
+
+STATIC mp_obj_t gauge_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args)
+{
+    return widget_make_new(type, n_args, n_kw, args, WIDGET_GAUGE);
+}
+
+STATIC mp_obj_t plot_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args)
+{
+    return widget_make_new(type, n_args, n_kw, args, WIDGET_PLOT);
+}
+
+/*
+    widget_scale() | Intern Function. Converts a value to 0..n in the range of the widget, out of range values are clipped.
+*/
+STATIC mp_int_t widget_scale(tftdisp_widget_obj_t *self, mp_obj_t value, mp_int_t n)
+{
+    mp_float_t f=(mp_obj_get_float(value)-self->vmin)/(self->vmax-self->vmin);
+    if(f<=0)
+    {
+        return 0;
+    }
+    if(f>=1)
+    {
+        return n;
+    }
+    return (mp_int_t)(f*n+MICROPY_FLOAT_CONST(0.5));
+}
+
+/*
+    Bar: horizontal when it is wider than high, otherwise vertical growing upwards. Only the part between
+    the previous and the new length is drawn.
+*/
+STATIC void bar_segment(tftdisp_widget_obj_t *self, mp_int_t from, mp_int_t to, uint16_t color)
+{
+    if(from>=to)
+    {
+        return;
+    }
+    if(self->w>=self->h)
+    {
+        fill_rect(self->tft, self->x+from, self->y, to-from, self->h, color);
+    }
+    else
+    {
+        fill_rect(self->tft, self->x, self->y+self->h-to, self->w, to-from, color);
+    }
+}
+
+STATIC void bar_update(tftdisp_widget_obj_t *self, mp_obj_t value)
+{
+    mp_int_t len=(self->w>=self->h) ? self->w : self->h;
+    mp_int_t level=widget_scale(self, value, len);
+    if(self->level<0)
+    {
+        bar_segment(self, 0, level, self->color);
+        bar_segment(self, level, len, self->color_bcknd);
+    }
+    else if(level>self->level)
+    {
+        bar_segment(self, self->level, level, self->color);
+    }
+    else
+    {
+        bar_segment(self, level, self->level, self->color_bcknd);
+    }
+    self->level=level;
+}
+
+/*
+    Gauge: dial of 270 degrees with a needle. The needle moves in steps of about one pixel at its tip,
+    update() erases the old needle and draws the new one only when the step changes.
+*/
+#define GAUGE_SWEEP     (MICROPY_FLOAT_CONST(4.712389))
+#define GAUGE_START     (MICROPY_FLOAT_CONST(3.926991))
+
+STATIC mp_int_t gauge_radius(tftdisp_widget_obj_t *self)
+{
+    return ((self->w<self->h) ? self->w : self->h)/2-1;
+}
+
+STATIC mp_int_t gauge_steps(tftdisp_widget_obj_t *self)
+{
+    return (mp_int_t)(GAUGE_SWEEP*gauge_radius(self)*3/4);
+}
+
+/*
+    gauge_ray() | Intern Function. Draws the segment of the ray of the step from the radius r0 to r1, in 1/8 of the radius.
+*/
+STATIC void gauge_ray(tftdisp_widget_obj_t *self, mp_int_t step, mp_int_t r0, mp_int_t r1, uint16_t color)
+{
+    mp_int_t r=gauge_radius(self);
+    mp_int_t cx=self->x+self->w/2;
+    mp_int_t cy=self->y+self->h/2;
+    mp_float_t a=GAUGE_START-GAUGE_SWEEP*step/gauge_steps(self);
+    mp_float_t c=MICROPY_FLOAT_C_FUN(cos)(a)*r/8;
+    mp_float_t s=MICROPY_FLOAT_C_FUN(sin)(a)*r/8;
+    line_int(self->tft, cx+(mp_int_t)(c*r0), cy-(mp_int_t)(s*r0), cx+(mp_int_t)(c*r1), cy-(mp_int_t)(s*r1), color);
+}
+
+STATIC void gauge_draw(tftdisp_widget_obj_t *self)
+{
+    mp_int_t r=gauge_radius(self);
+    mp_int_t cx=self->x+self->w/2;
+    mp_int_t cy=self->y+self->h/2;
+    fill_circle_int(self->tft, cx, cy, r, 0, 0, self->color_bcknd);
+    circle_int(self->tft, cx, cy, r, 0, 0, self->color);
+    //Ticks every quarter of the range
+    for(mp_int_t i=0; i<=4; i++)
+    {
+        gauge_ray(self, gauge_steps(self)*i/4, 7, 8, self->color);
+    }
+}
+
+STATIC void gauge_update(tftdisp_widget_obj_t *self, mp_obj_t value)
+{
+    mp_int_t level=widget_scale(self, value, gauge_steps(self));
+    if(self->level<0)
+    {
+        gauge_draw(self);
+    }
+    else if(level==self->level)
+    {
+        return;
+    }
+    else
+    {
+        gauge_ray(self, self->level, 0, 6, self->color_bcknd);
+    }
+    gauge_ray(self, level, 0, 6, self->color);
+    self->level=level;
+}
+
+/*
+    Plot: strip chart that sweeps from left to right like an oscilloscope, the trace of every sample is the
+    vertical span from the previous sample. A new sample erases the trace of its column, draws its own and
+    clears the next column to show the cursor, at most three small spans instead of the whole chart.
+*/
+STATIC void plot_erase(tftdisp_widget_obj_t *self, mp_int_t col)
+{
+    uint8_t *span=&self->span[2*col];
+    if(span[0]!=PLOT_EMPTY)
+    {
+        vspan(self->tft, self->x+col, self->y+span[0], self->y+span[1], self->color_bcknd);
+        span[0]=PLOT_EMPTY;
+        span[1]=PLOT_EMPTY;
+    }
+}
+
+STATIC void plot_update(tftdisp_widget_obj_t *self, mp_obj_t value)
+{
+    if(self->level<0)
+    {
+        fill_rect(self->tft, self->x, self->y, self->w, self->h, self->color_bcknd);
+        self->level=0;
+    }
+    mp_int_t col=self->cursor;
+    mp_int_t row=self->h-1-widget_scale(self, value, self->h-1);
+    mp_int_t prev=(col==0 || self->last_row<0) ? row : self->last_row;
+    plot_erase(self, col);
+    uint8_t *span=&self->span[2*col];
+    span[0]=(prev<row) ? prev : row;
+    span[1]=(prev<row) ? row : prev;
+    vspan(self->tft, self->x+col, self->y+span[0], self->y+span[1], self->color);
+    self->cursor=(col+1)%self->w;
+    self->last_row=row;
+    plot_erase(self, self->cursor);
+}
+
+/*
+    update() | Draws a new value on the widget. A Plot also takes a list or tuple of samples.
+    Example in uPython:
+        bar=ophyra_tftdisp.Bar(tft, 10, 10, 140, 12, 0, 100, 0x07E0, 0)
+        plot=ophyra_tftdisp.Plot(tft, 0, 40, 160, 80, -2, 2, 0xFFE0, 0)
+        while True:
+            ax=mpu.read_accel()[0]
+            bar.update(abs(ax)*50)
+            plot.update(ax)
+*/
+STATIC mp_obj_t widget_update(mp_obj_t self_in, mp_obj_t value)
+{
+    tftdisp_widget_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if(self->kind==WIDGET_BAR)
+    {
+        bar_update(self, value);
+    }
+    else if(self->kind==WIDGET_GAUGE)
+    {
+        gauge_update(self, value);
+    }
+    else if(mp_obj_is_type(value, &mp_type_list) || mp_obj_is_type(value, &mp_type_tuple))
+    {
+        size_t n;
+        mp_obj_t *items;
+        mp_obj_get_array(value, &n, &items);
+        for(size_t i=0; i<n; i++)
+        {
+            plot_update(self, items[i]);
+        }
+    }
+    else
+    {
+        plot_update(self, value);
+    }
+    return mp_const_none;
+}
+
+/*
+    draw() | Paints the whole widget again with its last value.
+*/
+STATIC mp_obj_t widget_draw(mp_obj_t self_in)
+{
+    tftdisp_widget_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if(self->kind==WIDGET_BAR && self->level>=0)
+    {
+        mp_int_t len=(self->w>=self->h) ? self->w : self->h;
+        bar_segment(self, 0, self->level, self->color);
+        bar_segment(self, self->level, len, self->color_bcknd);
+    }
+    else if(self->kind==WIDGET_GAUGE && self->level>=0)
+    {
+        gauge_draw(self);
+        gauge_ray(self, self->level, 0, 6, self->color);
+    }
+    else if(self->kind==WIDGET_PLOT)
+    {
+        fill_rect(self->tft, self->x, self->y, self->w, self->h, self->color_bcknd);
+        for(mp_int_t col=0; col<self->w; col++)
+        {
+            uint8_t *span=&self->span[2*col];
+            if(span[0]!=PLOT_EMPTY)
+            {
+                vspan(self->tft, self->x+col, self->y+span[0], self->y+span[1], self->color);
+            }
+        }
+        self->level=0;
+    }
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_2(widget_update_obj, widget_update);
+MP_DEFINE_CONST_FUN_OBJ_1(widget_draw_obj, widget_draw);
+
+STATIC const mp_rom_map_elem_t tftdisp_widget_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_update), MP_ROM_PTR(&widget_update_obj) },
+    { MP_ROM_QSTR(MP_QSTR_draw), MP_ROM_PTR(&widget_draw_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(tftdisp_widget_locals_dict, tftdisp_widget_locals_dict_table);
+
+const mp_obj_type_t tftdisp_bar_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_Bar,
+    .make_new = bar_make_new,
+    .locals_dict = (mp_obj_dict_t*)&tftdisp_widget_locals_dict,
+};
+
+const mp_obj_type_t tftdisp_gauge_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_Gauge,
+    .make_new = gauge_make_new,
+    .locals_dict = (mp_obj_dict_t*)&tftdisp_widget_locals_dict,
+};
+
+const mp_obj_type_t tftdisp_plot_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_Plot,
+    .make_new = plot_make_new,
+    .locals_dict = (mp_obj_dict_t*)&tftdisp_widget_locals_dict,
+};
+
 STATIC const mp_rom_map_elem_t ophyra_tftdisp_globals_table[] = {
                                                     //File name (User C module)
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ophyra_tftdisp) },
             //Class name                //Name of the associated "type".
     { MP_ROM_QSTR(MP_QSTR_ST7735), MP_ROM_PTR(&tftdisp_class_type) },
+    { MP_ROM_QSTR(MP_QSTR_Bar), MP_ROM_PTR(&tftdisp_bar_type) },
+    { MP_ROM_QSTR(MP_QSTR_Gauge), MP_ROM_PTR(&tftdisp_gauge_type) },
+    { MP_ROM_QSTR(MP_QSTR_Plot), MP_ROM_PTR(&tftdisp_plot_type) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_ophyra_tftdisp_globals, ophyra_tftdisp_globals_table);
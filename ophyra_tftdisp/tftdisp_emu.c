@@ -0,0 +1,403 @@
+/*
+    tftdisp_emu.c
+
+    Software model of the ST7735 display for the MicroPython unix port, see tftdisp_emu.h.
+    Intesc Electronica y Embebidos.
+
+    The model decodes the command stream sent by ophyra_tftdisp.c:
+        -> CASET/RASET set the address window and RAMWR/RAMRD write or read it in RGB565.
+        -> MADCTL (MX, MY, MV) maps the addresses to the display RAM like the controller does.
+        -> SWRESET and the RST pin clear the state.
+    The rest of the commands are counted and their parameters ignored.
+*/
+
+#ifndef TFTDISP_EMULATOR
+#define TFTDISP_EMULATOR (0)
+#endif
+
+#if TFTDISP_EMULATOR
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tftdisp_emu.h"
+
+#define EMU_CMD_SWRESET (0x01)
+#define EMU_CMD_CASET   (0x2A)
+#define EMU_CMD_RASET   (0x2B)
+#define EMU_CMD_RAMWR   (0x2C)
+#define EMU_CMD_RAMRD   (0x2E)
+#define EMU_CMD_MADCTL  (0x36)
+
+#define EMU_MADCTL_MY   (0x80)
+#define EMU_MADCTL_MX   (0x40)
+#define EMU_MADCTL_MV   (0x20)
+
+const pin_obj_t tftdisp_emu_pins[4]={ {EMU_PIN_DC}, {EMU_PIN_CS}, {EMU_PIN_RST}, {EMU_PIN_BL} };
+const spi_t spi_obj[1]={ {1} };
+tftdisp_emu_stats_t tftdisp_emu_stats;
+
+/*
+    State of the model.
+*/
+static uint16_t emu_ram[EMU_RAM_ROWS][EMU_RAM_COLS];
+static struct {
+    bool dc;
+    bool cs;
+    uint8_t cmd;
+    uint8_t nargs;
+    uint8_t args[4];
+    uint8_t madctl;
+    uint16_t xs, xe, ys, ye;
+    uint16_t x, y;
+    // RAMWR: first byte of the pixel in progress. RAMRD: byte of the pixel to return next.
+    bool half;
+    uint8_t hi;
+    uint8_t read_byte;
+} emu={ .cs=true };
+
+/*
+    emu_map() | Converts an address (col, row) to a position of the display RAM applying MADCTL.
+    Returns false if it is outside the RAM.
+*/
+static bool emu_map(uint16_t col, uint16_t row, uint16_t *ram_col, uint16_t *ram_row)
+{
+    if(emu.madctl & EMU_MADCTL_MV)
+    {
+        uint16_t t=col;
+        col=row;
+        row=t;
+    }
+    if(col>=EMU_RAM_COLS || row>=EMU_RAM_ROWS)
+    {
+        return false;
+    }
+    *ram_col=(emu.madctl & EMU_MADCTL_MX) ? EMU_RAM_COLS-1-col : col;
+    *ram_row=(emu.madctl & EMU_MADCTL_MY) ? EMU_RAM_ROWS-1-row : row;
+    return true;
+}
+
+static void emu_reset(void)
+{
+    emu.cmd=0;
+    emu.nargs=0;
+    emu.madctl=0;
+    emu.xs=0;
+    emu.xe=EMU_RAM_COLS-1;
+    emu.ys=0;
+    emu.ye=EMU_RAM_ROWS-1;
+    emu.x=0;
+    emu.y=0;
+    emu.half=false;
+}
+
+/*
+    emu_advance() | Moves the RAM pointer to the next address of the window, column first.
+*/
+static void emu_advance(void)
+{
+    if(emu.x<emu.xe)
+    {
+        emu.x++;
+        return;
+    }
+    emu.x=emu.xs;
+    emu.y=(emu.y<emu.ye) ? emu.y+1 : emu.ys;
+}
+
+static void emu_command(uint8_t cmd)
+{
+    tftdisp_emu_stats.commands++;
+    emu.cmd=cmd;
+    emu.nargs=0;
+    emu.half=false;
+    emu.read_byte=0;
+    if(cmd==EMU_CMD_SWRESET)
+    {
+        emu_reset();
+    }
+    if(cmd==EMU_CMD_RAMWR || cmd==EMU_CMD_RAMRD)
+    {
+        emu.x=emu.xs;
+        emu.y=emu.ys;
+    }
+}
+
+static void emu_data(uint8_t data)
+{
+    switch(emu.cmd)
+    {
+        case EMU_CMD_CASET:
+        case EMU_CMD_RASET:
+            if(emu.nargs<4)
+            {
+                emu.args[emu.nargs++]=data;
+            }
+            if(emu.nargs==4)
+            {
+                uint16_t start=(emu.args[0]<<8) | emu.args[1];
+                uint16_t end=(emu.args[2]<<8) | emu.args[3];
+                if(emu.cmd==EMU_CMD_CASET)
+                {
+                    emu.xs=start;
+                    emu.xe=end;
+                }
+                else
+                {
+                    emu.ys=start;
+                    emu.ye=end;
+                }
+            }
+            break;
+        case EMU_CMD_MADCTL:
+            emu.madctl=data;
+            break;
+        case EMU_CMD_RAMWR:
+            if(!emu.half)
+            {
+                emu.hi=data;
+                emu.half=true;
+                break;
+            }
+            emu.half=false;
+            uint16_t col, row;
+            if(emu_map(emu.x, emu.y, &col, &row))
+            {
+                emu_ram[row][col]=(emu.hi<<8) | data;
+            }
+            tftdisp_emu_stats.pixels++;
+            emu_advance();
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+    emu_read() | Returns the next byte of RAMRD: a dummy byte and then 3 bytes per pixel,
+    with 6 bits of red, green and blue aligned to the left like the controller.
+*/
+static uint8_t emu_read(void)
+{
+    if(emu.cmd!=EMU_CMD_RAMRD)
+    {
+        return 0;
+    }
+    if(!emu.half)
+    {
+        //Dummy read
+        emu.half=true;
+        return 0;
+    }
+    uint16_t col, row;
+    uint16_t c=emu_map(emu.x, emu.y, &col, &row) ? emu_ram[row][col] : 0;
+    uint8_t out;
+    switch(emu.read_byte)
+    {
+        case 0:
+            out=(c>>8)&0xF8;
+            break;
+        case 1:
+            out=(c>>3)&0xFC;
+            break;
+        default:
+            out=(c<<3)&0xF8;
+            break;
+    }
+    if(++emu.read_byte==3)
+    {
+        emu.read_byte=0;
+        emu_advance();
+    }
+    return out;
+}
+
+void tftdisp_emu_pin(const pin_obj_t *pin, int level)
+{
+    switch(pin->id)
+    {
+        case EMU_PIN_DC:
+            emu.dc=level;
+            break;
+        case EMU_PIN_CS:
+            if(emu.cs && !level)
+            {
+                tftdisp_emu_stats.transactions++;
+            }
+            emu.cs=level;
+            break;
+        case EMU_PIN_RST:
+            if(!level)
+            {
+                emu_reset();
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void spi_transfer(const spi_t *self, size_t len, const uint8_t *src, uint8_t *dest, uint32_t timeout)
+{
+    (void)self;
+    (void)timeout;
+    if(emu.cs)
+    {
+        //The display is not selected
+        return;
+    }
+    for(size_t i=0; i<len; i++)
+    {
+        tftdisp_emu_stats.bytes++;
+        if(dest!=NULL)
+        {
+            dest[i]=emu_read();
+        }
+        else if(!emu.dc)
+        {
+            emu_command(src[i]);
+        }
+        else
+        {
+            emu_data(src[i]);
+        }
+    }
+}
+
+uint16_t tftdisp_emu_get_pixel(uint16_t col, uint16_t row)
+{
+    uint16_t ram_col, ram_row;
+    if(!emu_map(col, row, &ram_col, &ram_row))
+    {
+        return 0;
+    }
+    return emu_ram[ram_row][ram_col];
+}
+
+/*
+    PNG output without compression: the image goes in stored deflate blocks, only CRC32 and Adler-32 are needed.
+*/
+static uint32_t png_crc(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc=~crc;
+    for(size_t i=0; i<len; i++)
+    {
+        crc^=data[i];
+        for(uint8_t k=0; k<8; k++)
+        {
+            crc=(crc>>1) ^ (0xEDB88320 & (0-(crc&1)));
+        }
+    }
+    return ~crc;
+}
+
+static void png_u32(uint8_t *p, uint32_t v)
+{
+    p[0]=v>>24;
+    p[1]=v>>16;
+    p[2]=v>>8;
+    p[3]=v;
+}
+
+static void png_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t len)
+{
+    uint8_t head[8];
+    png_u32(head, len);
+    memcpy(&head[4], type, 4);
+    fwrite(head, 1, 8, f);
+    if(len>0)
+    {
+        fwrite(data, 1, len, f);
+    }
+    uint32_t crc=png_crc(png_crc(0, (const uint8_t *)type, 4), data, len);
+    png_u32(head, crc);
+    fwrite(head, 1, 4, f);
+}
+
+static void emu_rgb(uint16_t c, uint8_t *rgb)
+{
+    rgb[0]=((c>>11)&0x1F)*255/31;
+    rgb[1]=((c>>5)&0x3F)*255/63;
+    rgb[2]=(c&0x1F)*255/31;
+}
+
+bool tftdisp_emu_dump(const char *path, uint16_t col, uint16_t row, uint16_t w, uint16_t h)
+{
+    if(w==0 || h==0)
+    {
+        //An empty image is not a valid PNG
+        return false;
+    }
+    FILE *f=fopen(path, "wb");
+    if(f==NULL)
+    {
+        return false;
+    }
+    size_t n=strlen(path);
+    if(n<4 || strcmp(&path[n-4], ".png")!=0)
+    {
+        fprintf(f, "P6\n%u %u\n255\n", w, h);
+        for(uint16_t j=0; j<h; j++)
+        {
+            for(uint16_t i=0; i<w; i++)
+            {
+                uint8_t rgb[3];
+                emu_rgb(tftdisp_emu_get_pixel(col+i, row+j), rgb);
+                fwrite(rgb, 1, 3, f);
+            }
+        }
+        fclose(f);
+        return true;
+    }
+
+    static const uint8_t signature[8]={0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, 8, f);
+    uint8_t ihdr[13]={0};
+    png_u32(&ihdr[0], w);
+    png_u32(&ihdr[4], h);
+    ihdr[8]=8;      // bit depth
+    ihdr[9]=2;      // truecolor
+    png_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+
+    //Every row is a filter byte and the RGB pixels, stored as one deflate block per row
+    size_t stride=1+3*(size_t)w;
+    size_t len=2+h*(5+stride)+4;
+    uint8_t *idat=malloc(len);
+    if(idat==NULL)
+    {
+        fclose(f);
+        return false;
+    }
+    uint8_t *p=idat;
+    *p++=0x78;
+    *p++=0x01;
+    uint32_t a=1, b=0;
+    for(uint16_t j=0; j<h; j++)
+    {
+        *p++=(j+1==h) ? 1 : 0;
+        *p++=stride&0xFF;
+        *p++=stride>>8;
+        *p++=~stride&0xFF;
+        *p++=(~stride>>8)&0xFF;
+        uint8_t *line=p;
+        *p++=0;
+        for(uint16_t i=0; i<w; i++)
+        {
+            emu_rgb(tftdisp_emu_get_pixel(col+i, row+j), p);
+            p+=3;
+        }
+        for(size_t k=0; k<stride; k++)
+        {
+            a=(a+line[k])%65521;
+            b=(b+a)%65521;
+        }
+    }
+    png_u32(p, (b<<16) | a);
+    png_chunk(f, "IDAT", idat, len);
+    free(idat);
+    png_chunk(f, "IEND", NULL, 0);
+    fclose(f);
+    return true;
+}
+
+#endif // TFTDISP_EMULATOR
@@ -0,0 +1,95 @@
+/*
+    tftdisp_emu.h
+
+    Software model of the ST7735 used to build ophyra_tftdisp.c on the MicroPython unix port.
+    Intesc Electronica y Embebidos.
+
+    When TFTDISP_EMULATOR is 1 this header replaces the STM32 pins and the SPI1 bus used by the driver:
+    write_cmd() and write_data() keep calling mp_hal_pin_high()/mp_hal_pin_low() and spi_transfer(),
+    but the bytes are decoded by tftdisp_emu.c (CASET, RASET, RAMWR, RAMRD, MADCTL...) into an in-memory
+    copy of the display RAM, which can be saved as a PPM or PNG image.
+    The model also counts the transactions (CS low periods), commands, bytes and pixels sent, so the SPI
+    cost of every drawing call can be measured on a Linux machine.
+
+    The micropython.mk of the module defines TFTDISP_EMULATOR=1 automatically when building the unix port:
+        make USER_C_MODULES=../../../modules CFLAGS_EXTRA=-DMODULE_OPHYRA_TFTDISP_ENABLED=1
+*/
+
+#ifndef TFTDISP_EMU_H
+#define TFTDISP_EMU_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+    Size of the ST7735 display RAM, the panel shows a part of it.
+*/
+#define EMU_RAM_COLS    (132)
+#define EMU_RAM_ROWS    (162)
+
+/*
+    Pins of the display, they are only identifiers for the model.
+*/
+typedef struct _pin_obj_t {
+    uint8_t id;
+} pin_obj_t;
+
+enum {
+    EMU_PIN_DC,
+    EMU_PIN_CS,
+    EMU_PIN_RST,
+    EMU_PIN_BL,
+};
+
+extern const pin_obj_t tftdisp_emu_pins[4];
+
+#define pin_D6  (&tftdisp_emu_pins[EMU_PIN_DC])
+#define pin_A15 (&tftdisp_emu_pins[EMU_PIN_CS])
+#define pin_D7  (&tftdisp_emu_pins[EMU_PIN_RST])
+#define pin_A7  (&tftdisp_emu_pins[EMU_PIN_BL])
+
+void tftdisp_emu_pin(const pin_obj_t *pin, int level);
+
+#undef mp_hal_pin_high
+#undef mp_hal_pin_low
+#undef mp_hal_pin_config
+#define mp_hal_pin_high(pin)                        tftdisp_emu_pin((pin), 1)
+#define mp_hal_pin_low(pin)                         tftdisp_emu_pin((pin), 0)
+#define mp_hal_pin_config(pin, mode, pull, alt)     ((void)(pin))
+
+/*
+    SPI bus, every transfer goes to the model.
+*/
+typedef struct _spi_t {
+    uint8_t id;
+} spi_t;
+
+extern const spi_t spi_obj[1];
+
+void spi_transfer(const spi_t *self, size_t len, const uint8_t *src, uint8_t *dest, uint32_t timeout);
+
+/*
+    Counters of the traffic sent to the model.
+*/
+typedef struct _tftdisp_emu_stats_t {
+    uint32_t transactions;
+    uint32_t commands;
+    uint32_t bytes;
+    uint32_t pixels;
+} tftdisp_emu_stats_t;
+
+extern tftdisp_emu_stats_t tftdisp_emu_stats;
+
+/*
+    Color of the pixel at the address (col, row) as the driver sees it with the current MADCTL, RGB565.
+*/
+uint16_t tftdisp_emu_get_pixel(uint16_t col, uint16_t row);
+
+/*
+    Saves the area of w*h pixels at the address (col, row) as a PPM image, or PNG when the path ends with ".png".
+    Returns false if the area is empty or the file can not be written.
+*/
+bool tftdisp_emu_dump(const char *path, uint16_t col, uint16_t row, uint16_t w, uint16_t h);
+
+#endif // TFTDISP_EMU_H
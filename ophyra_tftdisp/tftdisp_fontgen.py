@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""
+    tftdisp_fontgen.py
+
+    Generates tftdisp_fonts.h, the fonts compiled into ophyra_tftdisp.c besides the 6x8 Font table.
+    Intesc Electronica y Embebidos.
+
+    Run it from this folder after changing a font, the generated header is kept in the repository:
+        python3 tftdisp_fontgen.py
+
+    Fonts generated:
+        -> font_prop8: proportional version of the 6x8 Font of ophyra_tftdisp.c, the empty columns are removed.
+        -> font_digits24: 24 pixels high anti-aliased (2 bits per pixel) font for numeric readouts with
+           tabular digits, sign, point, colon and space. The glyphs are drawn with strokes and rasterized
+           with 4x4 supersampling.
+
+    Glyph format (see tftdisp_font_t in ophyra_tftdisp.c): the glyphs are stored column by column,
+    every column uses (height*bpp+7)//8 bytes and the pixel of row r is at bit r*bpp (LSB first).
+"""
+
+import math
+import os
+import re
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def font_6x8():
+    """Reads the Font table of ophyra_tftdisp.c, 96 glyphs of 6 columns."""
+    with open(os.path.join(HERE, "ophyra_tftdisp.c")) as f:
+        src = f.read()
+    table = re.search(r"const uint8_t Font\[\]=\s*\{(.*?)\};", src, re.S).group(1)
+    data = [int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]{2}", table)]
+    return [data[i:i + 6] for i in range(0, len(data), 6)]
+
+
+def prop8():
+    glyphs = []
+    for cols in font_6x8():
+        used = [i for i, c in enumerate(cols) if c]
+        if not used:
+            # Space
+            glyphs.append([0, 0, 0])
+        else:
+            glyphs.append(cols[used[0]:used[-1] + 1])
+    return glyphs
+
+
+# Strokes of the digits24 glyphs, in pixels inside a box of width x 24.
+# ("line", x0, y0, x1, y1), ("arc", cx, cy, rx, ry, a0, a1) with the angles in degrees
+# counterclockwise and the y axis down, ("dot", x, y).
+DIGITS24 = {
+    " ": (7, []),
+    "+": (12, [("line", 6, 8, 6, 18), ("line", 1.5, 13, 10.5, 13)]),
+    "-": (10, [("line", 2, 13, 8, 13)]),
+    ".": (6, [("dot", 3, 21)]),
+    ":": (6, [("dot", 3, 9), ("dot", 3, 19)]),
+    "0": (14, [("arc", 7, 12, 5, 10, 0, 360)]),
+    "1": (14, [("line", 7.5, 2, 7.5, 22), ("line", 7.5, 2, 3.5, 5.5)]),
+    "2": (14, [("arc", 7, 7, 5, 5, 160, -40), ("line", 10.83, 10.21, 2, 22), ("line", 2, 22, 12, 22)]),
+    "3": (14, [("arc", 7, 6.8, 4.6, 4.8, 150, -90), ("arc", 7, 16.5, 5, 5.5, 90, -150)]),
+    "4": (14, [("line", 10, 2, 2, 16), ("line", 2, 16, 12.5, 16), ("line", 10, 2, 10, 22)]),
+    "5": (14, [("line", 11.5, 2, 3.5, 2), ("line", 3.5, 2, 3.17, 11.3), ("arc", 7, 15.5, 5, 6.5, 140, -150)]),
+    "6": (14, [("arc", 7, 15.5, 5, 6.5, 0, 360), ("arc", 12, 15.5, 10, 13.5, 180, 100)]),
+    "7": (14, [("line", 2, 2, 12, 2), ("line", 12, 2, 5, 22)]),
+    "8": (14, [("arc", 7, 6.8, 4.3, 4.8, 0, 360), ("arc", 7, 16.5, 5, 5.5, 0, 360)]),
+    "9": (14, [("arc", 7, 8.5, 5, 6.5, 0, 360), ("arc", 2, 8.5, 10, 13.5, 0, -80)]),
+}
+STROKE = 1.5
+DOT = 2.0
+
+
+def segments(strokes):
+    segs = []
+    for s in strokes:
+        if s[0] == "line":
+            segs.append(s[1:5])
+        elif s[0] == "dot":
+            segs.append((s[1], s[2], s[1], s[2]))
+        else:
+            _, cx, cy, rx, ry, a0, a1 = s
+            n = max(8, int(abs(a1 - a0) / 6))
+            pts = []
+            for i in range(n + 1):
+                a = math.radians(a0 + (a1 - a0) * i / n)
+                pts.append((cx + rx * math.cos(a), cy - ry * math.sin(a)))
+            for p, q in zip(pts, pts[1:]):
+                segs.append(p + q)
+    return segs
+
+
+def distance(px, py, seg):
+    x0, y0, x1, y1 = seg
+    dx, dy = x1 - x0, y1 - y0
+    d2 = dx * dx + dy * dy
+    t = 0 if d2 == 0 else max(0, min(1, ((px - x0) * dx + (py - y0) * dy) / d2))
+    return math.hypot(px - x0 - t * dx, py - y0 - t * dy)
+
+
+def digits24():
+    glyphs = {}
+    for ch, (width, strokes) in DIGITS24.items():
+        segs = segments(strokes)
+        radius = [DOT if s[0:2] == s[2:4] else STROKE for s in segs]
+        cols = []
+        for x in range(width):
+            col = []
+            for y in range(24):
+                inside = 0
+                for sy in range(4):
+                    for sx in range(4):
+                        px, py = x + (sx + 0.5) / 4, y + (sy + 0.5) / 4
+                        if any(distance(px, py, s) <= r for s, r in zip(segs, radius)):
+                            inside += 1
+                col.append(round(inside * 3 / 16))
+            cols.append(col)
+        glyphs[ch] = cols
+    return glyphs
+
+
+def pack(cols, height, bpp):
+    out = []
+    for col in cols:
+        if isinstance(col, int):
+            col = [(col >> r) & 1 for r in range(height)]
+        value = 0
+        for r, level in enumerate(col):
+            value |= level << (r * bpp)
+        out += [(value >> (8 * i)) & 0xFF for i in range((height * bpp + 7) // 8)]
+    return out
+
+
+def emit(name, glyphs, first, last, height, bpp, spacing, comment):
+    data, offset, widths = [], [], []
+    for code in range(first, last + 1):
+        cols = glyphs.get(chr(code), [])
+        offset.append(len(data))
+        widths.append(len(cols))
+        data += pack(cols, height, bpp)
+    lines = ["/*", "    %s" % comment, "*/"]
+    lines.append("STATIC const uint8_t %s_data[]=\n{" % name)
+    for i in range(0, len(data), 12):
+        lines.append(", ".join("0x%02X" % v for v in data[i:i + 12]) + ",")
+    lines.append("};")
+    lines.append("STATIC const uint16_t %s_offset[]=\n{" % name)
+    for i in range(0, len(offset), 12):
+        lines.append(", ".join("%d" % v for v in offset[i:i + 12]) + ",")
+    lines.append("};")
+    lines.append("STATIC const uint8_t %s_widths[]=\n{" % name)
+    for i in range(0, len(widths), 16):
+        lines.append(", ".join("%d" % v for v in widths[i:i + 16]) + ",")
+    lines.append("};")
+    lines.append("STATIC const tftdisp_font_t %s=" % name)
+    lines.append("{")
+    lines.append("    .data=%s_data," % name)
+    lines.append("    .offset=%s_offset," % name)
+    lines.append("    .widths=%s_widths," % name)
+    lines.append("    .width=%d," % max(widths))
+    lines.append("    .height=%d," % height)
+    lines.append("    .first=%d," % first)
+    lines.append("    .last=%d," % last)
+    lines.append("    .bpp=%d," % bpp)
+    lines.append("    .spacing=%d," % spacing)
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    prop = prop8()
+    out = [
+        "/*",
+        "    tftdisp_fonts.h",
+        "",
+        "    Fonts of ophyra_tftdisp.c generated by tftdisp_fontgen.py, do not edit.",
+        "    Intesc Electronica y Embebidos.",
+        "",
+        "    Only included by ophyra_tftdisp.c after the definition of tftdisp_font_t.",
+        "*/",
+        "",
+        emit("font_prop8", {chr(32 + i): g for i, g in enumerate(prop)}, 32, 32 + len(prop) - 1, 8, 1, 1,
+             "Proportional 8 pixels font, the 6x8 Font without its empty columns."),
+        emit("font_digits24", digits24(), 32, 58, 24, 2, 2,
+             "Anti-aliased 24 pixels font for readouts: digits, + - . : and space."),
+    ]
+    with open(os.path.join(HERE, "tftdisp_fonts.h"), "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,203 @@
+/*
+    tftdisp_fonts.h
+
+    Fonts of ophyra_tftdisp.c generated by tftdisp_fontgen.py, do not edit.
+    Intesc Electronica y Embebidos.
+
+    Only included by ophyra_tftdisp.c after the definition of tftdisp_font_t.
+*/
+
+/*
+    Proportional 8 pixels font, the 6x8 Font without its empty columns.
+*/
+STATIC const uint8_t font_prop8_data[]=
+{
+0x00, 0x00, 0x00, 0x06, 0x5F, 0x06, 0x07, 0x03, 0x00, 0x07, 0x03, 0x24,
+0x7E, 0x24, 0x7E, 0x24, 0x24, 0x2B, 0x6A, 0x12, 0x63, 0x13, 0x08, 0x64,
+0x63, 0x36, 0x49, 0x56, 0x20, 0x50, 0x07, 0x03, 0x3E, 0x41, 0x41, 0x3E,
+0x08, 0x3E, 0x1C, 0x3E, 0x08, 0x08, 0x08, 0x3E, 0x08, 0x08, 0xE0, 0x60,
+0x08, 0x08, 0x08, 0x08, 0x08, 0x60, 0x60, 0x20, 0x10, 0x08, 0x04, 0x02,
+0x3E, 0x51, 0x49, 0x45, 0x3E, 0x42, 0x7F, 0x40, 0x62, 0x51, 0x49, 0x49,
+0x46, 0x22, 0x49, 0x49, 0x49, 0x36, 0x18, 0x14, 0x12, 0x7F, 0x10, 0x2F,
+0x49, 0x49, 0x49, 0x31, 0x3C, 0x4A, 0x49, 0x49, 0x30, 0x01, 0x71, 0x09,
+0x05, 0x03, 0x36, 0x49, 0x49, 0x49, 0x36, 0x06, 0x49, 0x49, 0x29, 0x1E,
+0x6C, 0x6C, 0xEC, 0x6C, 0x08, 0x14, 0x22, 0x41, 0x24, 0x24, 0x24, 0x24,
+0x24, 0x41, 0x22, 0x14, 0x08, 0x02, 0x01, 0x59, 0x09, 0x06, 0x3E, 0x41,
+0x5D, 0x55, 0x1E, 0x7E, 0x11, 0x11, 0x11, 0x7E, 0x7F, 0x49, 0x49, 0x49,
+0x36, 0x3E, 0x41, 0x41, 0x41, 0x22, 0x7F, 0x41, 0x41, 0x41, 0x3E, 0x7F,
+0x49, 0x49, 0x49, 0x41, 0x7F, 0x09, 0x09, 0x09, 0x01, 0x3E, 0x41, 0x49,
+0x49, 0x7A, 0x7F, 0x08, 0x08, 0x08, 0x7F, 0x41, 0x7F, 0x41, 0x30, 0x40,
+0x40, 0x40, 0x3F, 0x7F, 0x08, 0x14, 0x22, 0x41, 0x7F, 0x40, 0x40, 0x40,
+0x40, 0x7F, 0x02, 0x04, 0x02, 0x7F, 0x7F, 0x02, 0x04, 0x08, 0x7F, 0x3E,
+0x41, 0x41, 0x41, 0x3E, 0x7F, 0x09, 0x09, 0x09, 0x06, 0x3E, 0x41, 0x51,
+0x21, 0x5E, 0x7F, 0x09, 0x09, 0x19, 0x66, 0x26, 0x49, 0x49, 0x49, 0x32,
+0x01, 0x01, 0x7F, 0x01, 0x01, 0x3F, 0x40, 0x40, 0x40, 0x3F, 0x1F, 0x20,
+0x40, 0x20, 0x1F, 0x3F, 0x40, 0x3C, 0x40, 0x3F, 0x63, 0x14, 0x08, 0x14,
+0x63, 0x07, 0x08, 0x70, 0x08, 0x07, 0x71, 0x49, 0x45, 0x43, 0x7F, 0x41,
+0x41, 0x02, 0x04, 0x08, 0x10, 0x20, 0x41, 0x41, 0x7F, 0x04, 0x02, 0x01,
+0x02, 0x04, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x03, 0x07, 0x20, 0x54,
+0x54, 0x54, 0x78, 0x7F, 0x44, 0x44, 0x44, 0x38, 0x38, 0x44, 0x44, 0x44,
+0x28, 0x38, 0x44, 0x44, 0x44, 0x7F, 0x38, 0x54, 0x54, 0x54, 0x08, 0x08,
+0x7E, 0x09, 0x09, 0x18, 0xA4, 0xA4, 0xA4, 0x7C, 0x7F, 0x04, 0x04, 0x78,
+0x7D, 0x40, 0x40, 0x80, 0x84, 0x7D, 0x7F, 0x10, 0x28, 0x44, 0x7F, 0x40,
+0x7C, 0x04, 0x18, 0x04, 0x78, 0x7C, 0x04, 0x04, 0x78, 0x38, 0x44, 0x44,
+0x44, 0x38, 0xFC, 0x44, 0x44, 0x44, 0x38, 0x38, 0x44, 0x44, 0x44, 0xFC,
+0x44, 0x78, 0x44, 0x04, 0x08, 0x08, 0x54, 0x54, 0x54, 0x20, 0x04, 0x3E,
+0x44, 0x24, 0x3C, 0x40, 0x20, 0x7C, 0x1C, 0x20, 0x40, 0x20, 0x1C, 0x3C,
+0x60, 0x30, 0x60, 0x3C, 0x6C, 0x10, 0x10, 0x6C, 0x9C, 0xA0, 0x60, 0x3C,
+0x64, 0x54, 0x54, 0x4C, 0x08, 0x3E, 0x41, 0x41, 0x77, 0x41, 0x41, 0x3E,
+0x08, 0x02, 0x01, 0x02, 0x01, 0x3C, 0x26, 0x23, 0x26, 0x3C,
+};
+STATIC const uint16_t font_prop8_offset[]=
+{
+0, 3, 6, 11, 16, 20, 25, 30, 32, 34, 36, 41,
+46, 48, 53, 55, 60, 65, 68, 73, 78, 83, 88, 93,
+98, 103, 108, 110, 112, 116, 121, 125, 130, 135, 140, 145,
+150, 155, 160, 165, 170, 175, 178, 183, 188, 193, 198, 203,
+208, 213, 218, 223, 228, 233, 238, 243, 248, 253, 258, 262,
+265, 270, 273, 278, 284, 286, 291, 296, 301, 306, 311, 315,
+320, 324, 326, 330, 334, 336, 341, 345, 350, 355, 360, 365,
+370, 374, 378, 383, 388, 392, 396, 400, 404, 405, 409, 413,
+};
+STATIC const uint8_t font_prop8_widths[]=
+{
+3, 3, 5, 5, 4, 5, 5, 2, 2, 2, 5, 5, 2, 5, 2, 5,
+5, 3, 5, 5, 5, 5, 5, 5, 5, 5, 2, 2, 4, 5, 4, 5,
+5, 5, 5, 5, 5, 5, 5, 5, 5, 3, 5, 5, 5, 5, 5, 5,
+5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 4, 3, 5, 3, 5, 6,
+2, 5, 5, 5, 5, 5, 4, 5, 4, 2, 4, 4, 2, 5, 4, 5,
+5, 5, 5, 5, 4, 4, 5, 5, 4, 4, 4, 4, 1, 4, 4, 5,
+};
+STATIC const tftdisp_font_t font_prop8=
+{
+    .data=font_prop8_data,
+    .offset=font_prop8_offset,
+    .widths=font_prop8_widths,
+    .width=6,
+    .height=8,
+    .first=32,
+    .last=127,
+    .bpp=1,
+    .spacing=1,
+};
+
+/*
+    Anti-aliased 24 pixels font for readouts: digits, + - . : and space.
+*/
+STATIC const uint8_t font_digits24_data[]=
+{
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00,
+0x00, 0x00, 0x80, 0x2F, 0x00, 0x00, 0x00, 0x00, 0x80, 0x2F, 0x00, 0x00,
+0x00, 0x00, 0x80, 0x2F, 0x00, 0x00, 0x00, 0x40, 0xAA, 0xAF, 0x1A, 0x00,
+0x00, 0xD0, 0xFF, 0xFF, 0x7F, 0x00, 0x00, 0xD0, 0xFF, 0xFF, 0x7F, 0x00,
+0x00, 0x40, 0xAA, 0xAF, 0x1A, 0x00, 0x00, 0x00, 0x80, 0x2F, 0x00, 0x00,
+0x00, 0x00, 0x80, 0x2F, 0x00, 0x00, 0x00, 0x00, 0x80, 0x2F, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00,
+0x00, 0x00, 0x40, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x80, 0x2F, 0x00, 0x00,
+0x00, 0x00, 0x80, 0x2F, 0x00, 0x00, 0x00, 0x00, 0x80, 0x2F, 0x00, 0x00,
+0x00, 0x00, 0x80, 0x2F, 0x00, 0x00, 0x00, 0x00, 0x80, 0x2F, 0x00, 0x00,
+0x00, 0x00, 0x80, 0x2F, 0x00, 0x00, 0x00, 0x00, 0x40, 0x1F, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x40, 0x1F, 0x00, 0x00, 0x00, 0x00, 0xC0, 0x3F,
+0x00, 0x00, 0x00, 0x00, 0xC0, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x40, 0x1F,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA5, 0x5A, 0x00, 0x00,
+0x00, 0xE4, 0xFF, 0xFF, 0x1B, 0x00, 0x40, 0xFF, 0xFF, 0xFF, 0xFF, 0x01,
+0xE0, 0xFF, 0xAA, 0xAA, 0xFF, 0x0B, 0xF8, 0x1F, 0x00, 0x00, 0xF4, 0x2F,
+0xFD, 0x02, 0x00, 0x00, 0x80, 0x7F, 0xBE, 0x00, 0x00, 0x00, 0x00, 0xBE,
+0xBE, 0x00, 0x00, 0x00, 0x00, 0xBE, 0xFD, 0x02, 0x00, 0x00, 0x80, 0x7F,
+0xF8, 0x1F, 0x00, 0x00, 0xF4, 0x2F, 0xE0, 0xFF, 0xAA, 0xAA, 0xFF, 0x0B,
+0x40, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x00, 0xE4, 0xFF, 0xFF, 0x1B, 0x00,
+0x00, 0x00, 0xA5, 0x5A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2E, 0x00, 0x00, 0x00, 0x00,
+0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0xD0, 0x2F, 0x00, 0x00, 0x00, 0x00,
+0xF4, 0x0B, 0x00, 0x00, 0x00, 0x00, 0xFC, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,
+0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0xFC, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x14,
+0x80, 0x2F, 0x00, 0x00, 0x00, 0x7E, 0xE0, 0x2F, 0x00, 0x00, 0xD0, 0xBF,
+0xF8, 0x1F, 0x00, 0x00, 0xF8, 0xBF, 0xFC, 0x02, 0x00, 0x00, 0xFE, 0xBF,
+0xFD, 0x00, 0x00, 0xD0, 0xBF, 0xBE, 0xBE, 0x00, 0x00, 0xF8, 0x2F, 0xBE,
+0xBE, 0x00, 0x00, 0xFE, 0x07, 0xBE, 0xFD, 0x00, 0xD0, 0xBF, 0x00, 0xBE,
+0xFC, 0x02, 0xF8, 0x2F, 0x00, 0xBE, 0xF8, 0xAF, 0xFF, 0x07, 0x00, 0xBE,
+0xE0, 0xFF, 0xBF, 0x00, 0x00, 0xBE, 0x80, 0xFF, 0x2F, 0x00, 0x00, 0x7D,
+0x00, 0xA4, 0x01, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x40, 0x02, 0x00, 0x00, 0xA0, 0x01, 0xD0, 0x0B, 0x00, 0x00, 0xF4, 0x0B,
+0xF4, 0x0B, 0x00, 0x00, 0xF0, 0x1F, 0xFC, 0x02, 0x00, 0x00, 0x80, 0x3F,
+0xFD, 0x00, 0x90, 0x01, 0x00, 0x7F, 0xBE, 0x00, 0xF4, 0x03, 0x00, 0xBE,
+0xBE, 0x00, 0xF8, 0x03, 0x00, 0xBE, 0xFD, 0x00, 0xF4, 0x03, 0x00, 0x7F,
+0xFC, 0x02, 0xFD, 0x0B, 0x80, 0x3F, 0xF4, 0xFF, 0xFF, 0xBF, 0xFA, 0x1F,
+0xD0, 0xFF, 0xBF, 0xFF, 0xFF, 0x0B, 0x40, 0xFE, 0x0B, 0xFD, 0xFF, 0x01,
+0x00, 0x00, 0x00, 0x50, 0x16, 0x00, 0x00, 0x00, 0x00, 0x40, 0x01, 0x00,
+0x00, 0x00, 0x00, 0xF4, 0x07, 0x00, 0x00, 0x00, 0x00, 0xFE, 0x0B, 0x00,
+0x00, 0x00, 0xE0, 0xFF, 0x0B, 0x00, 0x00, 0x00, 0xFD, 0xFF, 0x0B, 0x00,
+0x00, 0xD0, 0xFF, 0xE2, 0x0B, 0x00, 0x00, 0xF8, 0x7F, 0xE0, 0x0B, 0x00,
+0x80, 0xFF, 0x07, 0xE0, 0x0B, 0x00, 0xF4, 0xFF, 0xAA, 0xEA, 0xAB, 0x1A,
+0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F,
+0xA4, 0xAA, 0xAA, 0xEA, 0xAB, 0x1A, 0x00, 0x00, 0x00, 0xE0, 0x0B, 0x00,
+0x00, 0x00, 0x00, 0xC0, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x50, 0x55, 0x00, 0xA4, 0x00, 0xFC, 0xFF, 0xFF, 0x02, 0xF8, 0x07,
+0xFE, 0xFF, 0xFF, 0x02, 0xF8, 0x1F, 0xFE, 0xAF, 0xBF, 0x01, 0x90, 0x3F,
+0xBE, 0x40, 0x3F, 0x00, 0x00, 0x7F, 0xBE, 0x80, 0x2F, 0x00, 0x00, 0xBE,
+0xBE, 0x80, 0x2F, 0x00, 0x00, 0xBE, 0xBE, 0x40, 0x3F, 0x00, 0x00, 0x7F,
+0xBE, 0x00, 0xBF, 0x01, 0x90, 0x3F, 0xBE, 0x00, 0xFD, 0xAB, 0xFA, 0x1F,
+0xBE, 0x00, 0xF4, 0xFF, 0xFF, 0x07, 0x3C, 0x00, 0x80, 0xFF, 0xBF, 0x00,
+0x00, 0x00, 0x00, 0xA4, 0x06, 0x00, 0x00, 0x00, 0x00, 0xA5, 0x06, 0x00,
+0x00, 0x00, 0xE8, 0xFF, 0xBF, 0x00, 0x00, 0x90, 0xFF, 0xFF, 0xFF, 0x07,
+0x00, 0xF8, 0xFF, 0xAB, 0xFA, 0x1F, 0x00, 0xFE, 0xBF, 0x01, 0x90, 0x3F,
+0x80, 0xFF, 0x3F, 0x00, 0x00, 0x7F, 0xE0, 0x9F, 0x2F, 0x00, 0x00, 0xBE,
+0xF4, 0x87, 0x2F, 0x00, 0x00, 0xBE, 0xF8, 0x42, 0x3F, 0x00, 0x00, 0x7F,
+0xFC, 0x00, 0xBF, 0x01, 0x90, 0x3F, 0xBD, 0x00, 0xFD, 0xAB, 0xFA, 0x1F,
+0x68, 0x00, 0xF4, 0xFF, 0xFF, 0x07, 0x00, 0x00, 0x80, 0xFF, 0xBF, 0x00,
+0x00, 0x00, 0x00, 0xA4, 0x06, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x7D, 0x00, 0x00, 0x00, 0x00, 0x00, 0xBE, 0x00, 0x00, 0x00, 0x00, 0x00,
+0xBE, 0x00, 0x00, 0x00, 0x00, 0x14, 0xBE, 0x00, 0x00, 0x00, 0x90, 0x7F,
+0xBE, 0x00, 0x00, 0x40, 0xFE, 0x7F, 0xBE, 0x00, 0x00, 0xF9, 0xFF, 0x1B,
+0xBE, 0x00, 0xE4, 0xFF, 0x6F, 0x00, 0xBE, 0x80, 0xFF, 0xFF, 0x02, 0x00,
+0xBE, 0xF9, 0xFF, 0x1B, 0x00, 0x00, 0xFE, 0xFF, 0x6F, 0x00, 0x00, 0x00,
+0xFE, 0xBF, 0x01, 0x00, 0x00, 0x00, 0xFD, 0x06, 0x00, 0x00, 0x00, 0x00,
+0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x16, 0x00,
+0x00, 0xA9, 0x06, 0xFD, 0xFF, 0x01, 0xD0, 0xFF, 0xAF, 0xFF, 0xFF, 0x0B,
+0xF4, 0xFF, 0xFF, 0xBF, 0xFA, 0x1F, 0xFC, 0x57, 0xFE, 0x0B, 0x80, 0x3F,
+0xFD, 0x00, 0xF8, 0x03, 0x00, 0x7F, 0xBE, 0x00, 0xF8, 0x03, 0x00, 0xBE,
+0xBE, 0x00, 0xF8, 0x03, 0x00, 0xBE, 0xFD, 0x00, 0xF8, 0x03, 0x00, 0x7F,
+0xFC, 0x57, 0xFE, 0x0B, 0x80, 0x3F, 0xF4, 0xFF, 0xFF, 0xBF, 0xFA, 0x1F,
+0xD0, 0xFF, 0xAF, 0xFF, 0xFF, 0x0B, 0x00, 0xA9, 0x06, 0xFD, 0xFF, 0x01,
+0x00, 0x00, 0x00, 0x50, 0x16, 0x00, 0x00, 0x90, 0x1A, 0x00, 0x00, 0x00,
+0x00, 0xFE, 0xFF, 0x02, 0x00, 0x00, 0xD0, 0xFF, 0xFF, 0x1F, 0x00, 0x29,
+0xF4, 0xAF, 0xEA, 0x7F, 0x00, 0x7E, 0xFC, 0x06, 0x40, 0xFE, 0x00, 0x3F,
+0xFD, 0x00, 0x00, 0xFC, 0x81, 0x2F, 0xBE, 0x00, 0x00, 0xF8, 0xD2, 0x1F,
+0xBE, 0x00, 0x00, 0xF8, 0xF6, 0x0B, 0xFD, 0x00, 0x00, 0xFC, 0xFF, 0x02,
+0xFC, 0x06, 0x40, 0xFE, 0xBF, 0x00, 0xF4, 0xAF, 0xEA, 0xFF, 0x2F, 0x00,
+0xD0, 0xFF, 0xFF, 0xFF, 0x06, 0x00, 0x00, 0xFE, 0xFF, 0x2B, 0x00, 0x00,
+0x00, 0x90, 0x5A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x40, 0x1F, 0x00, 0xF4, 0x01, 0x00, 0xC0, 0x3F, 0x00, 0xFC, 0x03,
+0x00, 0xC0, 0x3F, 0x00, 0xFC, 0x03, 0x00, 0x40, 0x1F, 0x00, 0xF4, 0x01,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+STATIC const uint16_t font_digits24_offset[]=
+{
+0, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42,
+114, 114, 174, 210, 210, 294, 378, 462, 546, 630, 714, 798,
+882, 966, 1050,
+};
+STATIC const uint8_t font_digits24_widths[]=
+{
+7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 0, 10, 6, 0,
+14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 6,
+};
+STATIC const tftdisp_font_t font_digits24=
+{
+    .data=font_digits24_data,
+    .offset=font_digits24_offset,
+    .widths=font_digits24_widths,
+    .width=14,
+    .height=24,
+    .first=32,
+    .last=58,
+    .bpp=2,
+    .spacing=2,
+};